@@ -1,6 +1,8 @@
 #include <algorithm>
+#include <cstring>
 
 #include "AvlTree/AvlIterator.h"
+#include "Utils/EndianUtils.h"
 
 AvlIterator::AvlIterator(AvlTree& avl_tree) 
 {
@@ -21,12 +23,77 @@ AvlIterator::AvlIterator(AvlTree& avl_tree)
         avl_entries_.push_back({ node->directory_start + node->offset, true, node }); // directory table nodes
     }
 
+    // Empty files share their start sector with the next file, they have to come first
     std::sort(avl_entries_.begin(), avl_entries_.end(), [](const Entry& a, const Entry& b) 
     {
-        return a.offset < b.offset;
+        if (a.offset != b.offset) 
+        {
+            return a.offset < b.offset;
+        }
+        return a.node->file_size < b.node->file_size;
     });
 }
 
+Xiso::DirectoryEntry::Header AvlIterator::directory_entry_header(const AvlTree::Node& node)
+{
+    Xiso::DirectoryEntry::Header dir_header;
+
+    dir_header.left_offset  = node.left_child ? static_cast<uint16_t>(node.left_child->offset / sizeof(uint32_t)) : 0;
+    dir_header.right_offset = node.right_child ? static_cast<uint16_t>(node.right_child->offset / sizeof(uint32_t)) : 0;
+    dir_header.start_sector = static_cast<uint32_t>(node.start_sector);
+    dir_header.file_size    = static_cast<uint32_t>(node.file_size + (node.subdirectory ? ((Xiso::SECTOR_SIZE - (node.file_size % Xiso::SECTOR_SIZE)) % Xiso::SECTOR_SIZE) : 0));
+    dir_header.attributes   = node.subdirectory ? Xiso::ATTRIBUTE_DIRECTORY : Xiso::ATTRIBUTE_FILE;
+    dir_header.name_length  = static_cast<uint8_t>(std::min(node.filename.size(), static_cast<size_t>(UINT8_MAX)));
+
+    EndianUtils::little_16(dir_header.left_offset);
+    EndianUtils::little_16(dir_header.right_offset);
+    EndianUtils::little_32(dir_header.start_sector);
+    EndianUtils::little_32(dir_header.file_size);
+
+    return dir_header;
+}
+
+size_t AvlIterator::write_directory_to_buffer(const std::vector<Entry>& avl_entries, const size_t start_index, std::vector<char>& entry_buffer)
+{
+    size_t entries_processed = 0;
+
+    for (uint64_t i = start_index; i < avl_entries.size(); ++i)
+    {
+        Xiso::DirectoryEntry::Header dir_header = directory_entry_header(*avl_entries[i].node);
+
+        uint64_t entry_len = sizeof(Xiso::DirectoryEntry::Header) + dir_header.name_length;
+        uint64_t buffer_pos = entry_buffer.size();
+
+        entry_buffer.resize(buffer_pos + entry_len, Xiso::PAD_BYTE);
+
+        std::memcpy(entry_buffer.data() + buffer_pos, &dir_header, sizeof(Xiso::DirectoryEntry::Header));
+        std::memcpy(entry_buffer.data() + buffer_pos + sizeof(Xiso::DirectoryEntry::Header), avl_entries[i].node->filename.c_str(), dir_header.name_length);
+
+        entries_processed++;
+
+        if (i == avl_entries.size() - 1 || 
+            !avl_entries[i + 1].directory_entry ||
+            avl_entries[i + 1].node->directory_start != avl_entries[i].node->directory_start) 
+        {
+            break;
+        }
+
+        uint64_t padding_len = avl_entries[i + 1].node->offset - entry_buffer.size();
+
+        if (padding_len > 0) 
+        {
+            entry_buffer.resize(entry_buffer.size() + padding_len, Xiso::PAD_BYTE);
+        }
+    }
+
+    if (entry_buffer.size() % Xiso::SECTOR_SIZE) //Pad up to sector boundary
+    {
+        entry_buffer.resize(entry_buffer.size() + (Xiso::SECTOR_SIZE - (entry_buffer.size() % Xiso::SECTOR_SIZE)), Xiso::PAD_BYTE);
+    }
+
+    return entries_processed;
+}
+
 void AvlIterator::collect_nodes(AvlTree::Node* node, std::vector<AvlTree::Node*>* context, int depth) 
 {
     if (!node || node == EMPTY_SUBDIRECTORY) 
@@ -24,6 +24,12 @@ public:
 
     const std::vector<Entry>& entries() const { return avl_entries_; }
 
+    static Xiso::DirectoryEntry::Header directory_entry_header(const AvlTree::Node& node);
+
+    /*  Writes the directory table that starts at avl_entries[start_index] to entry_buffer, 
+        padded to a sector boundary. Returns the number of entries processed. */
+    static size_t write_directory_to_buffer(const std::vector<Entry>& avl_entries, const size_t start_index, std::vector<char>& entry_buffer);
+
 private:
     std::vector<Entry> avl_entries_;
     
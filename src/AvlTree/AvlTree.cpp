@@ -18,6 +18,14 @@ AvlTree::AvlTree(const std::string& root_name, const std::filesystem::path& root
     calculate_all();
 }
 
+AvlTree::AvlTree(const std::string& root_name, ZARReader& zar_reader) 
+    : root_(root_name) 
+{
+    root_.start_sector = Xiso::ROOT_DIRECTORY_SECTOR;
+    generate_from_zar(zar_reader, "", &root_.subdirectory);
+    calculate_all();
+}
+
 // Calculated total resulting ISO size in bytes
 uint64_t AvlTree::out_iso_size() 
 {
@@ -7,10 +7,11 @@
 #include <functional>
 
 #include "Formats/Xiso.h"
+#include "ZARExtractor/ZARReader.h"
 
 #define EMPTY_SUBDIRECTORY (reinterpret_cast<AvlTree::Node*>(1))
 
-/*  Class will construct an AVL tree from a vector of Xiso::DirectoryEntry structs or a filesystem directory,
+/*  Class will construct an AVL tree from a vector of Xiso::DirectoryEntry structs, a filesystem directory or a ZAR archive,
     as well as calculate the required directory size and offsets for each directory node for use in an ISO.
     The Traverse method is provided so it can be used with a custom TraversalCallback, used to perform file IO. */
 class AvlTree {
@@ -33,7 +34,7 @@ public:
         Node* left_child{nullptr};
         Node* right_child{nullptr};
 
-        std::filesystem::path path; // Abs path if created from filesystem, otherwise relative to root directory of ISO
+        std::filesystem::path path; // Abs path if created from filesystem, path in the archive if created from ZAR, otherwise relative to root directory of ISO
 
         Node(const std::string& name) 
             : filename(name) {}
@@ -58,6 +59,7 @@ public:
     
     AvlTree(const std::string& root_name, std::vector<Xiso::DirectoryEntry> directory_entries); 
     AvlTree(const std::string& root_name, const std::filesystem::path& root_directory);
+    AvlTree(const std::string& root_name, ZARReader& zar_reader);
 
     Node* root() { return &root_; }
 
@@ -95,6 +97,7 @@ private:
     uint64_t num_sectors(uint64_t bytes);
 
     void generate_from_filesystem(const std::filesystem::path& in_directory, Node** dir_node);
+    void generate_from_zar(ZARReader& zar_reader, const std::string& dir_path, Node** dir_node);
     void generate_from_directory_entries(std::vector<Xiso::DirectoryEntry>& directory_entries, Node** dir_node); 
 
     void calculate_directory_requirements(Node* node, void* context, int depth);
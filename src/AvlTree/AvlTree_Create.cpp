@@ -49,6 +49,44 @@ void AvlTree::generate_from_filesystem(const std::filesystem::path& in_directory
     }
 }
 
+void AvlTree::generate_from_zar(ZARReader& zar_reader, const std::string& dir_path, Node** dir_node) 
+{
+    for (const ZARReader::Entry& entry : zar_reader.directory_entries(dir_path)) 
+    {
+        Node* current_node = new Node(entry.name);
+        current_node->path = entry.path;
+
+        if (entry.is_directory) 
+        {
+            generate_from_zar(zar_reader, entry.path, &current_node->subdirectory);
+
+            if (!current_node->subdirectory) 
+            {
+                current_node->subdirectory = EMPTY_SUBDIRECTORY;
+            }
+        } 
+        else 
+        {
+            if (entry.size > UINT32_MAX) 
+            {
+                XGDLog(Error) << "Warning: File size exceeds maximum allowed in XISO format:.\nSkipping: " << entry.path << "\n";
+                delete current_node;
+                continue;
+            }
+
+            current_node->file_size = entry.size;
+
+            total_bytes_ += current_node->file_size;
+            ++total_files_;
+        }
+
+        if (insert_node(dir_node, current_node) == AvlTree::Result::Error) 
+        {
+            throw XGDException(ErrCode::AVL_INSERT, HERE(), entry.path);
+        }
+    }
+}
+
 void AvlTree::generate_from_directory_entries(std::vector<Xiso::DirectoryEntry>& directory_entries, Node** dir_node) 
 {
     for (auto it = directory_entries.begin(); it != directory_entries.end(); ) 
@@ -8,21 +8,19 @@
 
 ExeTool::ExeTool(const std::filesystem::path& in_exe_path) 
 {
-    if (StringUtils::case_insensitive_search(in_exe_path.string(), ".xex")) 
-    {
-        platform_ = Platform::X360;
-        get_xex_cert_from_xex(in_exe_path);
-    } 
-    else if (StringUtils::case_insensitive_search(in_exe_path.string(), ".xbe")) 
-    {
-        platform_ = Platform::OGX;
-        get_xbe_cert_from_xbe(in_exe_path);
-        create_xex_cert_from_xbe();
-    }
-    else 
+    std::ifstream in_file(in_exe_path, std::ios::binary);
+    if (!in_file.is_open()) 
     {
-        throw XGDException(ErrCode::MISC, HERE(), "Invalid executable file extension.");
+        throw XGDException(ErrCode::FILE_OPEN, HERE(), in_exe_path.string());
     }
+
+    get_cert_from_stream(in_file, in_exe_path.string());
+}
+
+ExeTool::ExeTool(ZARReader& zar_reader, const std::string& exe_path) 
+{
+    std::unique_ptr<std::istream> in_file = zar_reader.open_file(exe_path);
+    get_cert_from_stream(*in_file, exe_path);
 }
 
 ExeTool::ExeTool(ImageReader& image_reader, const std::filesystem::path& entry_path) 
@@ -70,14 +68,27 @@ uint32_t ExeTool::title_id()
     return title_id_;
 }
 
-void ExeTool::get_xbe_cert_from_xbe(const std::filesystem::path& in_xbe_path) 
+void ExeTool::get_cert_from_stream(std::istream& in_file, const std::string& exe_path) 
 {
-    std::ifstream in_file(in_xbe_path, std::ios::binary);
-    if (!in_file.is_open()) 
+    if (StringUtils::case_insensitive_search(exe_path, ".xex")) 
+    {
+        platform_ = Platform::X360;
+        get_xex_cert_from_xex(in_file);
+    } 
+    else if (StringUtils::case_insensitive_search(exe_path, ".xbe")) 
     {
-        throw XGDException(ErrCode::FILE_OPEN, HERE(), in_xbe_path.string());
+        platform_ = Platform::OGX;
+        get_xbe_cert_from_xbe(in_file, exe_path);
+        create_xex_cert_from_xbe();
+    }
+    else 
+    {
+        throw XGDException(ErrCode::MISC, HERE(), "Invalid executable file extension.");
     }
+}
 
+void ExeTool::get_xbe_cert_from_xbe(std::istream& in_file, const std::string& exe_path) 
+{
     Xbe::Header xbe_header;
     in_file.read(reinterpret_cast<char*>(&xbe_header), sizeof(Xbe::Header));
 
@@ -92,42 +103,20 @@ void ExeTool::get_xbe_cert_from_xbe(const std::filesystem::path& in_xbe_path)
     in_file.read(reinterpret_cast<char*>(&xbe_cert_), sizeof(Xbe::Cert));
     if (in_file.fail()) 
     {
-        throw XGDException(ErrCode::FILE_READ, HERE(), in_xbe_path.string());
+        throw XGDException(ErrCode::FILE_READ, HERE(), exe_path);
     }
-
-    in_file.close();
 }
 
 void ExeTool::get_xbe_cert_from_reader(ImageReader& image_reader, const std::filesystem::path& node_path) 
 {
-    Xiso::DirectoryEntry exe_entry;
-    bool found = false;
-    
-    if (image_reader.executable_entry().path == node_path) 
-    {
-        exe_entry = image_reader.executable_entry();
-        found = true;
-    }
-    else
-    {
-        for (auto& entry : image_reader.directory_entries()) 
-        {
-            if (entry.path == node_path) 
-            {
-                exe_entry = entry;
-                found = true;
-                XGDLog(Debug) << "Found executable entry in directory entries: " << node_path.string() << "\n";
-                break;
-            }
-        }
-    }
+    const Xiso::DirectoryEntry* exe_entry = image_reader.find_entry(node_path);
 
-    if (!found) 
+    if (!exe_entry) 
     {
-        throw XGDException(ErrCode::MISC, HERE(), "Failed to find executable entry in directory entries.");
+        throw XGDException(ErrCode::MISC, HERE(), "Failed to find executable entry in image.");
     }
 
-    exe_offset_ = static_cast<uint64_t>(exe_entry.header.start_sector) * Xiso::SECTOR_SIZE;
+    exe_offset_ = static_cast<uint64_t>(exe_entry->header.start_sector) * Xiso::SECTOR_SIZE;
     exe_offset_ += image_reader.image_offset();
 
     Xbe::Header xbe_header;
@@ -144,14 +133,8 @@ void ExeTool::get_xbe_cert_from_reader(ImageReader& image_reader, const std::fil
     image_reader.read_bytes(exe_offset_ + cert_offset_, sizeof(Xbe::Cert), reinterpret_cast<char*>(&xbe_cert_));
 }
 
-void ExeTool::get_xex_cert_from_xex(const std::filesystem::path& in_xex_path) 
+void ExeTool::get_xex_cert_from_xex(std::istream& in_file) 
 {
-    std::ifstream in_file(in_xex_path, std::ios::binary);
-    if (!in_file.is_open()) 
-    {
-        throw XGDException(ErrCode::FILE_OPEN, HERE(), in_xex_path.string());
-    }
-
     Xex::Header xex_header;
     in_file.read(reinterpret_cast<char*>(&xex_header), sizeof(Xex::Header));
 
@@ -194,39 +177,18 @@ void ExeTool::get_xex_cert_from_xex(const std::filesystem::path& in_xex_path)
             break;
         }
     }
-    in_file.close();
 }
 
 void ExeTool::get_xex_cert_from_reader(ImageReader& image_reader, const std::filesystem::path& node_path) 
 {
-    Xiso::DirectoryEntry exe_entry;
-    bool found = false;
-    
-    if (image_reader.executable_entry().path == node_path) 
-    {
-        exe_entry = image_reader.executable_entry();
-        found = true;
-    }
-    else
-    {
-        for (auto& entry : image_reader.directory_entries()) 
-        {
-            if (entry.path == node_path) 
-            {
-                exe_entry = entry;
-                found = true;
-                XGDLog(Debug) << "Found executable entry in directory entries: " << node_path.string() << "\n";
-                break;
-            }
-        }
-    }
+    const Xiso::DirectoryEntry* exe_entry = image_reader.find_entry(node_path);
 
-    if (!found) 
+    if (!exe_entry) 
     {
-        throw XGDException(ErrCode::MISC, HERE(), "Failed to find executable entry in directory entries.");
+        throw XGDException(ErrCode::MISC, HERE(), "Failed to find executable entry in image.");
     }
 
-    exe_offset_ = static_cast<uint64_t>(exe_entry.header.start_sector) * Xiso::SECTOR_SIZE;
+    exe_offset_ = static_cast<uint64_t>(exe_entry->header.start_sector) * Xiso::SECTOR_SIZE;
     exe_offset_ += image_reader.image_offset();
 
     Xex::Header xex_header;
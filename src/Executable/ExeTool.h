@@ -3,8 +3,10 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <istream>
 
 #include "ImageReader/ImageReader.h"
+#include "ZARExtractor/ZARReader.h"
 #include "InputHelper/Types.h"
 #include "Formats/Xex.h"
 #include "Formats/Xbe.h"
@@ -14,6 +16,7 @@ class ExeTool
 public:
     ExeTool(const std::filesystem::path& in_exe_path);
     ExeTool(ImageReader& image_reader, const std::filesystem::path& entry_path);
+    ExeTool(ZARReader& zar_reader, const std::string& exe_path);
 
     ~ExeTool() = default;
 
@@ -41,8 +44,9 @@ private:
     Xbe::Cert xbe_cert_;
     uint32_t title_id_{0};
 
-    void get_xbe_cert_from_xbe(const std::filesystem::path& in_xbe_path);
-    void get_xex_cert_from_xex(const std::filesystem::path& in_xex_path);
+    void get_cert_from_stream(std::istream& in_file, const std::string& exe_path);
+    void get_xbe_cert_from_xbe(std::istream& in_file, const std::string& exe_path);
+    void get_xex_cert_from_xex(std::istream& in_file);
     void get_xex_cert_from_reader(ImageReader& image_reader, const std::filesystem::path& node_path);
     void get_xbe_cert_from_reader(ImageReader& image_reader, const std::filesystem::path& node_path);
     void create_xex_cert_from_xbe();
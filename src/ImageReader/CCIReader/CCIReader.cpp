@@ -10,13 +10,13 @@
 CCIReader::CCIReader(const std::vector<std::filesystem::path>& in_cci_paths) 
     : in_cci_paths_(in_cci_paths) 
 {
-    for (const auto& path : in_cci_paths_) 
+    try 
     {
-        in_files_.push_back(std::make_unique<std::ifstream>(path, std::ios::binary));
-        if (!in_files_.back()->is_open()) 
-        {
-            throw XGDException(ErrCode::FILE_OPEN, HERE(), path.string());
-        }
+        in_file_ = split::pread_file(in_cci_paths_);
+    } 
+    catch (const std::exception& e) 
+    {
+        throw XGDException(ErrCode::FILE_OPEN, HERE(), e.what());
     }
 
     verify_and_populate_index_infos();
@@ -25,29 +25,24 @@ CCIReader::CCIReader(const std::vector<std::filesystem::path>& in_cci_paths)
     {
         total_sectors_ += static_cast<uint32_t>(index_info.size()) - 1;
     }
+
+    set_sector_cache_size(SectorCache::DEFAULT_CAPACITY);
 }
 
 CCIReader::~CCIReader() 
 {
-    for (auto& in_file : in_files_) 
-    {
-        in_file->close();
-    }
-    in_files_.clear();
+    in_file_.close();
 }
 
 void CCIReader::verify_and_populate_index_infos() 
 {
-    index_infos_.resize(in_files_.size());   
+    index_infos_.resize(in_file_.num_parts());   
 
-    for (int i = 0; i < in_files_.size(); ++i) 
+    for (size_t i = 0; i < in_file_.num_parts(); ++i) 
     {
-        in_files_[i]->seekg(0, std::ios::beg);
-
         CCI::Header header;
 
-        in_files_[i]->read(reinterpret_cast<char*>(&header), sizeof(CCI::Header));
-        if (in_files_[i]->fail()) 
+        if (in_file_.read_part(i, 0, reinterpret_cast<char*>(&header), sizeof(CCI::Header)) != sizeof(CCI::Header)) 
         {
             throw XGDException(ErrCode::FILE_READ, HERE());
         }
@@ -60,51 +55,151 @@ void CCIReader::verify_and_populate_index_infos()
         {
             throw XGDException(ErrCode::ISO_INVALID, HERE());
         }
-        
-        index_infos_[i].reserve(static_cast<uint32_t>(header.uncompressed_size / CCI::BLOCK_SIZE) + 1);
 
-        in_files_[i]->seekg(header.index_offset, std::ios::beg);
+        std::vector<uint32_t> raw_index(static_cast<size_t>(header.uncompressed_size / CCI::BLOCK_SIZE) + 1);
+        size_t raw_index_size = raw_index.size() * sizeof(uint32_t);
 
-        for (uint32_t j = 0; j <= static_cast<uint32_t>(header.uncompressed_size / CCI::BLOCK_SIZE); ++j) 
+        if (in_file_.read_part(i, header.index_offset, reinterpret_cast<char*>(raw_index.data()), raw_index_size) != raw_index_size) 
         {
-            uint32_t index;
-            
-            in_files_[i]->read(reinterpret_cast<char*>(&index), sizeof(uint32_t));
-            if (in_files_[i]->fail()) 
-            {
-                throw XGDException(ErrCode::FILE_READ, HERE());
-            }
+            throw XGDException(ErrCode::FILE_READ, HERE());
+        }
 
+        index_infos_[i].reserve(raw_index.size());
+
+        for (uint32_t index : raw_index) 
+        {
             index_infos_[i].push_back({ (index & 0x7FFFFFFF) << CCI::INDEX_ALIGNMENT, ((index & 0x80000000) > 0) });
         }
     }
 }
 
-void CCIReader::read_sector(const uint32_t sector, char* out_buffer) 
+void CCIReader::read_sector_uncached(const uint32_t sector, char* out_buffer) 
 {
-    int idx = (sector > index_infos_[0].size() - 2) ? 1 : 0; //Final index in each file doesn't represent a sector
+    read_sectors(sector, 1, out_buffer);
+}
+
+void CCIReader::read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer) 
+{
+    const uint32_t max_run_sectors = 512;
+    const uint32_t sectors_per_task = 16;
+    const uint32_t part_1_sectors = static_cast<uint32_t>(index_infos_[0].size()) - 1; //Final index in each file doesn't represent a sector
+
+    // Reused between calls so steady state bulk reads don't allocate
+    static thread_local std::vector<char> read_buffer;
 
-    if (idx > 0 && in_files_.size() < 2)
+    uint32_t end_sector = start_sector + count;
+    uint32_t current_sector = start_sector;
+
+    while (current_sector < end_sector) 
     {
-        throw XGDException(ErrCode::MISC, HERE(), "Sector requested is out of bounds");
+        int idx = (current_sector >= part_1_sectors) ? 1 : 0;
+
+        if (idx > 0 && in_file_.num_parts() < 2)
+        {
+            throw XGDException(ErrCode::MISC, HERE(), "Sector requested is out of bounds");
+        }
+
+        // Blocks within a part are stored back to back, so each run is one read
+        uint32_t part_end = (idx == 0) ? part_1_sectors : total_sectors_;
+        uint32_t run_end = std::min({ end_sector, part_end, current_sector + max_run_sectors });
+        uint32_t first_in_file = current_sector - (idx * part_1_sectors);
+        uint32_t last_in_file = run_end - (idx * part_1_sectors);
+
+        const std::vector<CCI::IndexInfo>& index_infos = index_infos_[idx];
+        uint64_t run_offset = index_infos[first_in_file].value;
+        size_t run_size = index_infos[last_in_file].value - index_infos[first_in_file].value;
+
+        if (read_buffer.size() < run_size) 
+        {
+            read_buffer.resize(run_size);
+        }
+
+        if (in_file_.read_part(idx, run_offset, read_buffer.data(), run_size) != run_size) 
+        {
+            throw XGDException(ErrCode::FILE_READ, HERE());
+        }
+
+        const char* run_buffer = read_buffer.data();
+        char* run_out_buffer = out_buffer + (static_cast<size_t>(current_sector - start_sector) * Xiso::SECTOR_SIZE);
+        uint32_t run_sectors = last_in_file - first_in_file;
+
+        WorkPool::shared().run((run_sectors + sectors_per_task - 1) / sectors_per_task, [&](size_t task_idx) 
+        {
+            uint32_t task_start = first_in_file + static_cast<uint32_t>(task_idx) * sectors_per_task;
+            uint32_t task_end = std::min(last_in_file, task_start + sectors_per_task);
+
+            for (uint32_t sector_in_file = task_start; sector_in_file < task_end; ++sector_in_file) 
+            {
+                const CCI::IndexInfo& index_info = index_infos[sector_in_file];
+
+                decode_block(   index_info, 
+                                run_buffer + (index_info.value - run_offset), 
+                                index_infos[sector_in_file + 1].value - index_info.value, 
+                                run_out_buffer + (static_cast<size_t>(sector_in_file - first_in_file) * Xiso::SECTOR_SIZE));
+            }
+        });
+
+        current_sector = run_end;
     }
+}
 
-    uint32_t sector_in_file = sector - (idx * (static_cast<uint32_t>(index_infos_[0].size()) - 1));
-    size_t compressed_size = index_infos_[idx][sector_in_file + 1].value - index_infos_[idx][sector_in_file].value;
+void CCIReader::read_lz4_blocks(const uint32_t start_sector, const uint32_t count, std::vector<char>& out_buffer, std::vector<LZ4Block>& out_blocks)
+{
+    const uint32_t part_1_sectors = static_cast<uint32_t>(index_infos_[0].size()) - 1;
 
-    if (index_infos_[idx][sector_in_file].compressed || compressed_size < Xiso::SECTOR_SIZE) 
+    out_buffer.clear();
+    out_blocks.clear();
+
+    uint32_t end_sector = start_sector + count;
+    uint32_t current_sector = start_sector;
+
+    while (current_sector < end_sector) 
     {
-        uint8_t padding_len;
+        int idx = (current_sector >= part_1_sectors) ? 1 : 0;
+
+        if (idx > 0 && in_file_.num_parts() < 2)
+        {
+            throw XGDException(ErrCode::MISC, HERE(), "Sector requested is out of bounds");
+        }
+
+        uint32_t run_end = std::min(end_sector, (idx == 0) ? part_1_sectors : total_sectors_);
+        uint32_t first_in_file = current_sector - (idx * part_1_sectors);
+        uint32_t last_in_file = run_end - (idx * part_1_sectors);
+
+        const std::vector<CCI::IndexInfo>& index_infos = index_infos_[idx];
+        uint64_t run_offset = index_infos[first_in_file].value;
+        size_t run_size = index_infos[last_in_file].value - index_infos[first_in_file].value;
+        size_t buffer_offset = out_buffer.size();
+
+        out_buffer.resize(buffer_offset + run_size);
+
+        if (in_file_.read_part(idx, run_offset, out_buffer.data() + buffer_offset, run_size) != run_size) 
+        {
+            throw XGDException(ErrCode::FILE_READ, HERE());
+        }
+
+        for (uint32_t sector_in_file = first_in_file; sector_in_file < last_in_file; ++sector_in_file) 
+        {
+            const CCI::IndexInfo& index_info = index_infos[sector_in_file];
+            size_t block_offset = buffer_offset + (index_info.value - run_offset);
 
-        in_files_[idx]->seekg(index_infos_[idx][sector_in_file].value, std::ios::beg);
-        in_files_[idx]->read(reinterpret_cast<char*>(&padding_len), sizeof(uint8_t));
+            LZ4Block block = parse_block(index_info, out_buffer.data() + block_offset, index_infos[sector_in_file + 1].value - index_info.value);
+            block.offset += block_offset;
 
-        compressed_size = compressed_size - (1 + padding_len);
+            out_blocks.push_back(block);
+        }
 
-        std::vector<char> read_buffer(Xiso::SECTOR_SIZE);
-        in_files_[idx]->read(read_buffer.data(), compressed_size);
+        current_sector = run_end;
+    }
+}
 
-        int decompressed_size = LZ4_decompress_safe(read_buffer.data(), out_buffer, static_cast<int>(compressed_size), Xiso::SECTOR_SIZE);
+void CCIReader::decode_block(const CCI::IndexInfo& index_info, const char* in_buffer, const size_t read_len, char* out_buffer) 
+{
+    LZ4Block block = parse_block(index_info, in_buffer, read_len);
+
+    if (block.compressed) 
+    {
+        int decompressed_size = LZ4_decompress_safe(in_buffer + block.offset, out_buffer, static_cast<int>(block.size), Xiso::SECTOR_SIZE);
         if (decompressed_size < 0 || (decompressed_size != Xiso::SECTOR_SIZE)) 
         {
             throw XGDException(ErrCode::MISC, HERE(), "LZ4_decompress_safe failed");
@@ -112,28 +207,24 @@ void CCIReader::read_sector(const uint32_t sector, char* out_buffer)
     } 
     else 
     {
-        in_files_[idx]->seekg(index_infos_[idx][sector_in_file].value, std::ios::beg);
-        in_files_[idx]->read(out_buffer, Xiso::SECTOR_SIZE);
-    }
-
-    if (in_files_[idx]->fail()) 
-    {
-        throw XGDException(ErrCode::FILE_READ, HERE());
+        std::memcpy(out_buffer, in_buffer + block.offset, Xiso::SECTOR_SIZE);
     }
 }
 
-void CCIReader::read_bytes(const uint64_t offset, const size_t size, char* out_buffer) 
+/*  Compressed blocks are a padding length byte, the LZ4 block, then that many bytes of padding. 
+    The returned offset is relative to in_buffer. */
+ImageReader::LZ4Block CCIReader::parse_block(const CCI::IndexInfo& index_info, const char* in_buffer, const size_t read_len) 
 {
-    uint32_t sectors_to_read = static_cast<uint32_t>(size / Xiso::SECTOR_SIZE) + ((size % Xiso::SECTOR_SIZE) ? 1 : 0);
-    uint32_t start_sector = static_cast<uint32_t>(offset / Xiso::SECTOR_SIZE);
-    size_t position_in_sector = offset % Xiso::SECTOR_SIZE;
-
-    std::vector<char> buffer(sectors_to_read * Xiso::SECTOR_SIZE);
-
-    for (uint32_t i = 0; i < sectors_to_read; ++i) 
+    if (index_info.compressed || read_len < Xiso::SECTOR_SIZE) 
     {
-        read_sector(start_sector + i, buffer.data() + (i * Xiso::SECTOR_SIZE));
-    }
+        uint8_t padding_len = (read_len > 0) ? static_cast<uint8_t>(in_buffer[0]) : 0;
+        if (read_len < static_cast<size_t>(1 + padding_len)) 
+        {
+            throw XGDException(ErrCode::ISO_INVALID, HERE(), "Invalid compressed block size");
+        }
+
+        return { 1, static_cast<uint32_t>(read_len - (1 + padding_len)), true };
+    } 
 
-    std::memcpy(out_buffer, buffer.data() + position_in_sector, size);
-}
\ No newline at end of file
+    return { 0, Xiso::SECTOR_SIZE, false };
+}
@@ -5,9 +5,9 @@
 #include <string>
 #include <vector>
 #include <unordered_set>
-#include <memory>
-#include <fstream>
+#include <filesystem>
 
+#include "SplitFStream/SplitFStream.h"
 #include "Formats/CCI.h"
 #include "ImageReader/ImageReader.h"
 
@@ -17,22 +17,29 @@ public:
     CCIReader(const std::vector<std::filesystem::path>& in_cci_paths);
     ~CCIReader() override;
 
-    void read_sector(const uint32_t sector, char* out_buffer) override;
-    void read_bytes(const uint64_t offset, const size_t size, char* out_buffer) override;
+    void read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer) override;
+
+    FileType lz4_block_format() override { return FileType::CCI; };
+    void read_lz4_blocks(const uint32_t start_sector, const uint32_t count, std::vector<char>& out_buffer, std::vector<LZ4Block>& out_blocks) override;
 
     uint64_t image_offset() override { return 0; };
     uint32_t total_sectors() override { return total_sectors_; };
 
     std::string name() override { return in_cci_paths_.front().stem().string(); };
 
+protected:
+    void read_sector_uncached(const uint32_t sector, char* out_buffer) override;
+
 private:
     std::vector<std::filesystem::path> in_cci_paths_;
-    std::vector<std::unique_ptr<std::ifstream>> in_files_;
+    split::pread_file in_file_;
 
     uint32_t total_sectors_{0};
     std::vector<std::vector<CCI::IndexInfo>> index_infos_;
 
     void verify_and_populate_index_infos();
+    void decode_block(const CCI::IndexInfo& index_info, const char* in_buffer, const size_t read_len, char* out_buffer);
+    LZ4Block parse_block(const CCI::IndexInfo& index_info, const char* in_buffer, const size_t read_len);
 };
 
 #endif // _CCI_READER_H_
\ No newline at end of file
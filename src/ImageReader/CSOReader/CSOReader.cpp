@@ -1,53 +1,43 @@
 #include <cstring>
+#include <algorithm>
+
+#include <lz4.h>
 
 #include "ImageReader/CSOReader/CSOReader.h"
 
 CSOReader::CSOReader(const std::vector<std::filesystem::path>& in_cso_paths)
     : in_cso_paths_(in_cso_paths)
 {
-    part_1_size_ = std::filesystem::file_size(in_cso_paths_.front());
-
-    for (const auto& path : in_cso_paths_) 
+    try 
     {
-        in_files_.push_back(std::make_unique<std::ifstream>(path, std::ios::binary));
-        if (!in_files_.back()->is_open()) 
-        {
-            throw XGDException(ErrCode::FILE_OPEN, HERE(), path.string());
-        }
+        in_file_ = split::pread_file(in_cso_paths_);
+    } 
+    catch (const std::exception& e) 
+    {
+        throw XGDException(ErrCode::FILE_OPEN, HERE(), e.what());
     }
 
+    part_1_size_ = in_file_.part_size(0);
+
     verify_and_populate_index_infos();
 
     total_sectors_ = static_cast<uint32_t>(index_infos_.size()) - 1;
 
-    LZ4F_errorCode_t lz4f_error = LZ4F_createDecompressionContext(&lz4f_dctx_, LZ4F_VERSION);
-    if (LZ4F_isError(lz4f_error)) 
-    {
-        throw XGDException(ErrCode::MISC, HERE(), LZ4F_getErrorName(lz4f_error));
-    }
+    set_sector_cache_size(SectorCache::DEFAULT_CAPACITY);
 }
 
 CSOReader::~CSOReader()
 {
-    LZ4F_freeDecompressionContext(lz4f_dctx_);
-
-    for (auto& file : in_files_) 
-    {
-        file->close();
-    }
-    in_files_.clear();
+    in_file_.close();
 }
 
 void CSOReader::verify_and_populate_index_infos()
 {
     index_infos_.clear();
 
-    in_files_[0]->seekg(0, std::ios::beg);
-
     CSO::Header header;
 
-    in_files_[0]->read(reinterpret_cast<char*>(&header), sizeof(CSO::Header));
-    if (in_files_[0]->fail()) 
+    if (in_file_.read_part(0, 0, reinterpret_cast<char*>(&header), sizeof(CSO::Header)) != sizeof(CSO::Header)) 
     {
         throw XGDException(ErrCode::FILE_READ, HERE());
     }
@@ -61,77 +51,185 @@ void CSOReader::verify_and_populate_index_infos()
         throw XGDException(ErrCode::ISO_INVALID, HERE());
     }
 
-    index_infos_.reserve(static_cast<uint32_t>(header.uncompressed_size / Xiso::SECTOR_SIZE) + 1);
+    std::vector<uint32_t> raw_index(static_cast<size_t>(header.uncompressed_size / CSO::BLOCK_SIZE) + 1);
+    size_t raw_index_size = raw_index.size() * sizeof(uint32_t);
+
+    if (in_file_.read_part(0, sizeof(CSO::Header), reinterpret_cast<char*>(raw_index.data()), raw_index_size) != raw_index_size) 
+    {
+        throw XGDException(ErrCode::FILE_READ, HERE());
+    }
+
+    index_infos_.reserve(raw_index.size());
+
+    for (uint32_t index : raw_index) 
+    {
+        index_infos_.push_back({ (index & 0x7FFFFFFF) << CSO::INDEX_ALIGNMENT, ((index & 0x80000000) > 0) });
+    }
+}
+
+void CSOReader::read_sector_uncached(const uint32_t sector, char* out_buffer)
+{
+    read_sectors(sector, 1, out_buffer);
+}
+
+void CSOReader::read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer)
+{
+    const uint32_t max_run_sectors = 512;
+    const uint32_t sectors_per_task = 16;
+
+    // Reused between calls so steady state bulk reads don't allocate
+    static thread_local std::vector<char> read_buffer;
+
+    uint32_t end_sector = start_sector + count;
+    uint32_t current_sector = start_sector;
 
-    for (uint32_t j = 0; j < (header.uncompressed_size / CSO::BLOCK_SIZE) + 1; ++j) 
+    while (current_sector < end_sector) 
     {
-        uint32_t index;
-        
-        in_files_[0]->read(reinterpret_cast<char*>(&index), sizeof(uint32_t));
-        if (in_files_[0]->fail()) 
+        // Blocks are stored back to back, so a run within one part is a single read
+        int file_idx = part_index(current_sector);
+        uint32_t run_end = current_sector + 1;
+
+        while (run_end < end_sector && (run_end - current_sector) < max_run_sectors && part_index(run_end) == file_idx) 
+        {
+            run_end++;
+        }
+
+        uint64_t run_offset = index_infos_[current_sector].value;
+        size_t run_size = index_infos_[run_end].value - index_infos_[current_sector].value;
+
+        if (read_buffer.size() < run_size + INDEX_SLACK) 
+        {
+            read_buffer.resize(run_size + INDEX_SLACK);
+        }
+
+        uint64_t bytes_read = in_file_.read_part(file_idx, run_offset, read_buffer.data(), run_size + INDEX_SLACK);
+        if (bytes_read < run_size) 
         {
             throw XGDException(ErrCode::FILE_READ, HERE());
         }
+        std::memset(read_buffer.data() + bytes_read, 0, static_cast<size_t>((run_size + INDEX_SLACK) - bytes_read));
 
-        index_infos_.push_back({ (index & 0x7FFFFFFF) << CSO::INDEX_ALIGNMENT, ((index & 0x80000000) > 0) });
+        const char* run_buffer = read_buffer.data();
+        uint32_t run_start = current_sector;
+        uint32_t run_sectors = run_end - run_start;
+
+        WorkPool::shared().run((run_sectors + sectors_per_task - 1) / sectors_per_task, [&](size_t task_idx) 
+        {
+            uint32_t task_start = run_start + static_cast<uint32_t>(task_idx) * sectors_per_task;
+            uint32_t task_end = std::min(run_end, task_start + sectors_per_task);
+
+            for (uint32_t sector = task_start; sector < task_end; ++sector) 
+            {
+                decode_block(   sector, 
+                                run_buffer + (index_infos_[sector].value - run_offset), 
+                                index_infos_[sector + 1].value - index_infos_[sector].value, 
+                                out_buffer + (static_cast<size_t>(sector - start_sector) * Xiso::SECTOR_SIZE));
+            }
+        });
+
+        current_sector = run_end;
     }
 }
 
-void CSOReader::read_sector(const uint32_t sector, char* out_buffer)
+void CSOReader::read_lz4_blocks(const uint32_t start_sector, const uint32_t count, std::vector<char>& out_buffer, std::vector<LZ4Block>& out_blocks)
 {
-    size_t read_len = index_infos_[sector + 1].value - index_infos_[sector].value;
-    int file_idx = (index_infos_[sector].value > part_1_size_) ? 1 : 0;
+    out_buffer.clear();
+    out_blocks.clear();
 
-    in_files_[file_idx]->seekg(index_infos_[sector].value, std::ios::beg);
+    uint32_t end_sector = start_sector + count;
+    uint32_t current_sector = start_sector;
 
-    if (index_infos_[sector].compressed || read_len < Xiso::SECTOR_SIZE)
+    while (current_sector < end_sector) 
     {
-        size_t compressed_size = sizeof(LZ4F_HEADER) + read_len + sizeof(LZ4F_FOOTER);
-        size_t decompressed_size = Xiso::SECTOR_SIZE;
+        int file_idx = part_index(current_sector);
+        uint32_t run_end = current_sector + 1;
+
+        while (run_end < end_sector && part_index(run_end) == file_idx) 
+        {
+            run_end++;
+        }
+
+        uint64_t run_offset = index_infos_[current_sector].value;
+        size_t run_size = index_infos_[run_end].value - index_infos_[current_sector].value;
+        size_t buffer_offset = out_buffer.size();
 
-        std::vector<char> read_buffer(compressed_size, 0);
-        std::memcpy(read_buffer.data(), LZ4F_HEADER, sizeof(LZ4F_HEADER));
+        out_buffer.resize(buffer_offset + run_size + INDEX_SLACK);
 
-        in_files_[file_idx]->read(read_buffer.data() + sizeof(LZ4F_HEADER), read_len);
-        if (in_files_[file_idx]->fail()) 
+        uint64_t bytes_read = in_file_.read_part(file_idx, run_offset, out_buffer.data() + buffer_offset, run_size + INDEX_SLACK);
+        if (bytes_read < run_size) 
         {
             throw XGDException(ErrCode::FILE_READ, HERE());
         }
+        std::memset(out_buffer.data() + buffer_offset + bytes_read, 0, static_cast<size_t>((run_size + INDEX_SLACK) - bytes_read));
 
-        std::memcpy(read_buffer.data() + sizeof(LZ4F_HEADER) + read_len, LZ4F_FOOTER, sizeof(LZ4F_FOOTER));
-
-        size_t lz4_decompressed_size = LZ4F_decompress(lz4f_dctx_, out_buffer, &decompressed_size, read_buffer.data(), &compressed_size, nullptr);
-        if (LZ4F_isError(lz4_decompressed_size)) 
+        for (uint32_t sector = current_sector; sector < run_end; ++sector) 
         {
-            throw XGDException(ErrCode::MISC, HERE(), LZ4F_getErrorName(lz4_decompressed_size));
+            size_t block_offset = buffer_offset + (index_infos_[sector].value - run_offset);
+
+            LZ4Block block = parse_block(sector, out_buffer.data() + block_offset, index_infos_[sector + 1].value - index_infos_[sector].value);
+            block.offset += block_offset;
+
+            out_blocks.push_back(block);
         }
+
+        current_sector = run_end;
     }
-    else if (read_len != Xiso::SECTOR_SIZE)
+}
+
+void CSOReader::decode_block(const uint32_t sector, const char* in_buffer, const size_t read_len, char* out_buffer)
+{
+    LZ4Block block = parse_block(sector, in_buffer, read_len);
+
+    if (block.compressed)
     {
-        throw XGDException(ErrCode::ISO_INVALID, HERE());
+        int decompressed_size = LZ4_decompress_safe(in_buffer + block.offset, out_buffer, static_cast<int>(block.size), Xiso::SECTOR_SIZE);
+        if (decompressed_size != Xiso::SECTOR_SIZE) 
+        {
+            throw XGDException(ErrCode::MISC, HERE(), "LZ4_decompress_safe failed");
+        }
     }
     else
     {
-        in_files_[file_idx]->read(out_buffer, Xiso::SECTOR_SIZE);
-        if (in_files_[file_idx]->fail()) 
-        {
-            throw XGDException(ErrCode::FILE_READ, HERE());
-        }
+        std::memcpy(out_buffer, in_buffer + block.offset, Xiso::SECTOR_SIZE);
     }
 }
 
-void CSOReader::read_bytes(const uint64_t offset, const size_t size, char* out_buffer) 
+// Finds the LZ4 block or uncompressed sector in a stored block, the returned offset is relative to in_buffer
+ImageReader::LZ4Block CSOReader::parse_block(const uint32_t sector, const char* in_buffer, const size_t read_len)
 {
-    uint32_t sectors_to_read = static_cast<uint32_t>(size / Xiso::SECTOR_SIZE) + ((size % Xiso::SECTOR_SIZE) ? 1 : 0);
-    uint32_t start_sector = static_cast<uint32_t>(offset / Xiso::SECTOR_SIZE);
-    size_t position_in_sector = offset % Xiso::SECTOR_SIZE;
+    if (index_infos_[sector].compressed || read_len < Xiso::SECTOR_SIZE)
+    {
+        /*  Blocks are single LZ4 frame blocks with the frame header and end mark stripped: 
+            a little endian block size, high bit set if stored uncompressed, followed by the block data. 
+            Anything after that is alignment padding. */
+        uint32_t block_size = 0;
 
-    std::vector<char> buffer(sectors_to_read * Xiso::SECTOR_SIZE);
+        if (read_len < sizeof(uint32_t)) 
+        {
+            throw XGDException(ErrCode::ISO_INVALID, HERE(), "Invalid compressed block size");
+        }
+
+        std::memcpy(&block_size, in_buffer, sizeof(uint32_t));
 
-    for (uint32_t i = 0; i < sectors_to_read; ++i) 
+        bool stored = (block_size & 0x80000000) != 0;
+        block_size &= 0x7FFFFFFF;
+
+        if (block_size > (read_len + INDEX_SLACK) - sizeof(uint32_t)) 
+        {
+            throw XGDException(ErrCode::ISO_INVALID, HERE(), "Invalid compressed block size");
+        }
+
+        if (stored && block_size != Xiso::SECTOR_SIZE) 
+        {
+            throw XGDException(ErrCode::ISO_INVALID, HERE(), "Invalid stored block size");
+        }
+
+        return { sizeof(uint32_t), block_size, !stored };
+    }
+    else if (read_len != Xiso::SECTOR_SIZE)
     {
-        read_sector(start_sector + i, buffer.data() + (i * Xiso::SECTOR_SIZE));
+        throw XGDException(ErrCode::ISO_INVALID, HERE());
     }
 
-    std::memcpy(out_buffer, buffer.data() + position_in_sector, size);
-}
\ No newline at end of file
+    return { 0, Xiso::SECTOR_SIZE, false };
+}
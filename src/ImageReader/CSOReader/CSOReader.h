@@ -5,11 +5,8 @@
 #include <string>
 #include <vector>
 #include <filesystem>
-#include <memory>
-#include <fstream>
-
-#include <lz4frame.h>
 
+#include "SplitFStream/SplitFStream.h"
 #include "Formats/CSO.h"
 #include "ImageReader/ImageReader.h"
 
@@ -19,27 +16,31 @@ public:
     CSOReader(const std::vector<std::filesystem::path>& in_cso_paths);
     ~CSOReader() override;
 
-    void read_sector(const uint32_t sector, char* out_buffer) override;
-    void read_bytes(const uint64_t offset, const size_t size, char* out_buffer) override;
+    void read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer) override;
+
+    FileType lz4_block_format() override { return FileType::CSO; };
+    void read_lz4_blocks(const uint32_t start_sector, const uint32_t count, std::vector<char>& out_buffer, std::vector<LZ4Block>& out_blocks) override;
 
     uint64_t image_offset() override { return 0; };
     uint32_t total_sectors() override { return total_sectors_; }
 
     std::string name() override { return in_cso_paths_.front().filename().string(); };
 
+protected:
+    void read_sector_uncached(const uint32_t sector, char* out_buffer) override;
+
 private:
     struct IndexInfo {
         uint32_t value;
         bool compressed;
     };
 
-    const uint8_t LZ4F_HEADER[7] = { 0x04, 0x22, 0x4D, 0x18, 0x60, 0x40, 0x82 };
-    const uint8_t LZ4F_FOOTER[4] = { 0x00, 0x00, 0x00, 0x00 };
-    
-    LZ4F_dctx* lz4f_dctx_{nullptr};
+    /*  The final index entry is the end of the last block rounded down to the index alignment, 
+        so the last block can run up to this many bytes past what the index says. */
+    static constexpr size_t INDEX_SLACK = (1 << CSO::INDEX_ALIGNMENT) - 1;
 
     std::vector<std::filesystem::path> in_cso_paths_;
-    std::vector<std::unique_ptr<std::ifstream>> in_files_;
+    split::pread_file in_file_;
 
     size_t part_1_size_{0};
     std::vector<IndexInfo> index_infos_;
@@ -47,6 +48,10 @@ private:
     uint32_t total_sectors_{0};
 
     void verify_and_populate_index_infos();
+    void decode_block(const uint32_t sector, const char* in_buffer, const size_t read_len, char* out_buffer);
+    LZ4Block parse_block(const uint32_t sector, const char* in_buffer, const size_t read_len);
+
+    int part_index(const uint32_t sector) { return (index_infos_[sector].value > part_1_size_) ? 1 : 0; };
 };
 
 #endif // _CSO_READER_H_
\ No newline at end of file
@@ -1,9 +1,13 @@
 #include <cstring>
 #include <algorithm>
 #include <numeric>
+#include <fstream>
+#include <atomic>
+#include <mutex>
 
 #include "XGD.h"
 #include "Utils/StringUtils.h"
+#include "Utils/HashUtils.h"
 #include "ImageReader/GoDReader/GoDReader.h"
 
 GoDReader::GoDReader(const std::vector<std::filesystem::path>& in_god_directory) 
@@ -16,34 +20,23 @@ GoDReader::GoDReader(const std::vector<std::filesystem::path>& in_god_directory)
         return a.string() < b.string();
     });
 
-    auto last_blocks = std::filesystem::file_size(in_god_data_paths_.back()) / GoD::BLOCK_SIZE;
-    auto last_hash_index = (last_blocks - 1) / (GoD::DATA_BLOCKS_PER_SHT + 1);
-    auto last_data_blocks = last_blocks - (last_hash_index + 1);
-    auto total_data_blocks = ((in_god_data_paths_.size() - 1) * GoD::DATA_BLOCKS_PER_PART) + last_data_blocks;
-
-    total_sectors_ = static_cast<uint32_t>(total_data_blocks * (GoD::BLOCK_SIZE / Xiso::SECTOR_SIZE));
-
-    for (const auto& data_path : in_god_data_paths_) 
+    try 
     {
-        in_files_.push_back(std::make_unique<std::ifstream>(data_path, std::ios::binary));
-        if (!in_files_.back()->is_open()) 
-        {
-            throw XGDException(ErrCode::FILE_OPEN, HERE(), data_path.string());
-        }
+        in_file_ = split::pread_file(in_god_data_paths_);
+    } 
+    catch (const std::exception& e) 
+    {
+        throw XGDException(ErrCode::FILE_OPEN, HERE(), e.what());
     }
 
-    XGDLog(Debug) << "GoD data files opened: " << in_files_.size() << "\n";
+    build_part_infos();
+
+    XGDLog(Debug) << "GoD data files opened: " << in_file_.num_parts() << "\n";
 }
 
 GoDReader::~GoDReader() 
 {
-    for (auto& in_file : in_files_) 
-    {
-        if (in_file->is_open()) 
-        {
-            in_file->close();
-        }
-    }
+    in_file_.close();
 }
 
 void GoDReader::populate_data_files(const std::filesystem::path& in_directory, int search_depth) 
@@ -65,51 +58,238 @@ void GoDReader::populate_data_files(const std::filesystem::path& in_directory, i
     }
 }
 
-GoDReader::Remap GoDReader::remap_sector(uint64_t xiso_sector) 
+void GoDReader::build_part_infos() 
 {
-    uint64_t block_num = (xiso_sector * Xiso::SECTOR_SIZE) / GoD::BLOCK_SIZE;
-    uint32_t file_index = static_cast<uint32_t>(block_num / GoD::DATA_BLOCKS_PER_PART);
-    uint64_t data_block_within_file = block_num % GoD::DATA_BLOCKS_PER_PART;
-    uint32_t hash_index = static_cast<uint32_t>(data_block_within_file / GoD::DATA_BLOCKS_PER_SHT);
-
-    uint64_t remapped_offset = GoD::BLOCK_SIZE; // master hashtable
-    remapped_offset += ((hash_index + 1) * GoD::BLOCK_SIZE); // Add subhash table blocks
-    remapped_offset += (data_block_within_file * GoD::BLOCK_SIZE); // Add data blocks
-    remapped_offset += (xiso_sector * Xiso::SECTOR_SIZE) % GoD::BLOCK_SIZE; // Add offset within data block
-    return { remapped_offset, file_index };
+    const uint64_t blocks_per_group = GoD::DATA_BLOCKS_PER_SHT + 1;
+
+    for (size_t i = 0; i < in_file_.num_parts(); ++i) 
+    {
+        // Master hashtable, then each sub hashtable followed by up to 204 data blocks
+        uint64_t part_blocks = in_file_.part_size(i) / GoD::BLOCK_SIZE;
+        uint64_t group_blocks = (part_blocks > 0) ? part_blocks - 1 : 0;
+        uint64_t num_groups = (group_blocks + blocks_per_group - 1) / blocks_per_group;
+        uint64_t num_data_blocks = group_blocks - num_groups;
+
+        // Every part but the last is full, and no part can hold more, map_extents relies on both
+        if (num_data_blocks > GoD::DATA_BLOCKS_PER_PART ||
+            (i + 1 < in_file_.num_parts() && num_data_blocks != GoD::DATA_BLOCKS_PER_PART)) 
+        {
+            throw XGDException(ErrCode::ISO_INVALID, HERE(), "GoD data file has an unexpected size: " + in_god_data_paths_[i].string());
+        }
+
+        part_infos_.push_back({ total_data_blocks_, num_data_blocks, static_cast<uint32_t>(num_groups) });
+        total_data_blocks_ += num_data_blocks;
+    }
+
+    total_sectors_ = static_cast<uint32_t>(total_data_blocks_ * (GoD::BLOCK_SIZE / Xiso::SECTOR_SIZE));
 }
 
-GoDReader::Remap GoDReader::remap_offset(uint64_t xiso_offset) 
+void GoDReader::map_extents(const uint64_t xiso_offset, const uint64_t size, std::vector<Extent>& out_extents) 
 {
-    Remap remapped = remap_sector(xiso_offset / Xiso::SECTOR_SIZE);
-    remapped.offset += (xiso_offset % Xiso::SECTOR_SIZE);
-    return { remapped.offset, remapped.file_index };
+    if (xiso_offset + size > total_data_blocks_ * GoD::BLOCK_SIZE) 
+    {
+        throw XGDException(ErrCode::FILE_READ, HERE(), "Read past end of GoD image");
+    }
+
+    uint64_t current_offset = xiso_offset;
+    uint64_t end_offset = xiso_offset + size;
+
+    while (current_offset < end_offset) 
+    {
+        uint64_t block_num = current_offset / GoD::BLOCK_SIZE;
+        uint64_t offset_in_block = current_offset % GoD::BLOCK_SIZE;
+
+        uint32_t file_index = static_cast<uint32_t>(block_num / GoD::DATA_BLOCKS_PER_PART);
+        const PartInfo& part_info = part_infos_[file_index];
+
+        uint64_t data_block = block_num - part_info.first_data_block;
+        uint64_t hash_index = data_block / GoD::DATA_BLOCKS_PER_SHT;
+
+        // Rest of the run up to the next sub hashtable or the end of the part
+        uint64_t run_end_block = std::min((hash_index + 1) * GoD::DATA_BLOCKS_PER_SHT, part_info.num_data_blocks);
+        uint64_t run_bytes = ((run_end_block - data_block) * GoD::BLOCK_SIZE) - offset_in_block;
+
+        Extent extent;
+        extent.file_index = file_index;
+        extent.offset = (GoD::BLOCK_SIZE * (1 + (hash_index + 1) + data_block)) + offset_in_block; // Master hashtable + sub hashtables + data blocks
+        extent.length = std::min(run_bytes, end_offset - current_offset);
+
+        out_extents.push_back(extent);
+        current_offset += extent.length;
+    }
 }
 
-void GoDReader::read_sector(const uint32_t sector, char* out_buffer) 
+void GoDReader::read_extents(const uint64_t xiso_offset, const uint64_t size, char* out_buffer) 
 {
-    Remap remap = remap_sector(static_cast<uint64_t>(sector));
-    in_files_[remap.file_index]->seekg(remap.offset, std::ios::beg);
-    in_files_[remap.file_index]->read(out_buffer, Xiso::SECTOR_SIZE);
-    if (in_files_[remap.file_index]->fail()) 
+    std::vector<Extent> extents;
+    map_extents(xiso_offset, size, extents);
+
+    for (const Extent& extent : extents) 
     {
-        throw XGDException(ErrCode::FILE_READ, HERE());
+        if (in_file_.read_part(extent.file_index, extent.offset, out_buffer, extent.length) != extent.length) 
+        {
+            throw XGDException(ErrCode::FILE_READ, HERE());
+        }
+        out_buffer += extent.length;
     }
-    XGDLog(Debug) << "Read sector " << sector << " from file " << remap.file_index << " at offset " << remap.offset << "\n";
+}
+
+void GoDReader::read_sector_uncached(const uint32_t sector, char* out_buffer) 
+{
+    read_sectors(sector, 1, out_buffer);
+}
+
+void GoDReader::read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer) 
+{
+    read_extents(static_cast<uint64_t>(start_sector) * Xiso::SECTOR_SIZE, static_cast<uint64_t>(count) * Xiso::SECTOR_SIZE, out_buffer);
 }
 
 void GoDReader::read_bytes(const uint64_t offset, const size_t size, char* out_buffer) 
 {
-    auto sectors_to_read = (size / Xiso::SECTOR_SIZE) + ((size % Xiso::SECTOR_SIZE) > 0 ? 1 : 0);
-    auto start_sector = offset / Xiso::SECTOR_SIZE;
-    auto start_offset = offset % Xiso::SECTOR_SIZE;
+    read_extents(offset, size, out_buffer);
+}
 
-    std::vector<char> buffer(sectors_to_read * Xiso::SECTOR_SIZE);
+bool GoDReader::verify_hash_group(const uint32_t file_index, const uint32_t hash_index, SHA1Hash& out_sht_hash) 
+{
+    const PartInfo& part_info = part_infos_[file_index];
+    uint64_t first_block = static_cast<uint64_t>(hash_index) * GoD::DATA_BLOCKS_PER_SHT;
+    uint64_t num_blocks = std::min(static_cast<uint64_t>(GoD::DATA_BLOCKS_PER_SHT), part_info.num_data_blocks - first_block);
+
+    // Sub hashtable and its data blocks are one contiguous read
+    thread_local std::vector<unsigned char> group_buffer;
+    group_buffer.resize((num_blocks + 1) * GoD::BLOCK_SIZE);
+
+    uint64_t group_offset = GoD::BLOCK_SIZE * (1 + (static_cast<uint64_t>(hash_index) * (GoD::DATA_BLOCKS_PER_SHT + 1)));
+
+    if (in_file_.read_part(file_index, group_offset, reinterpret_cast<char*>(group_buffer.data()), group_buffer.size()) != group_buffer.size()) 
+    {
+        throw XGDException(ErrCode::FILE_READ, HERE(), in_god_data_paths_[file_index].string());
+    }
 
-    for (auto i = 0; i < sectors_to_read; i++) 
+    HashUtils::sha1(reinterpret_cast<const char*>(group_buffer.data()), GoD::BLOCK_SIZE, out_sht_hash.data());
+
+    // A damaged part can end on a sub hashtable with no data blocks after it
+    if (num_blocks == 0) 
     {
-        read_sector(static_cast<uint32_t>(start_sector + i), buffer.data() + (i * Xiso::SECTOR_SIZE));
+        return true;
     }
 
-    std::memcpy(out_buffer, buffer.data() + start_offset, size);
-}
\ No newline at end of file
+    thread_local std::vector<SHA1Hash> block_hashes;
+    block_hashes.resize(num_blocks);
+
+    HashUtils::sha1_blocks(reinterpret_cast<const char*>(group_buffer.data()) + GoD::BLOCK_SIZE, GoD::BLOCK_SIZE, num_blocks, block_hashes[0].data());
+
+    bool valid = true;
+
+    for (uint64_t i = 0; i < num_blocks; ++i) 
+    {
+        if (std::memcmp(block_hashes[i].data(), group_buffer.data() + (i * sizeof(SHA1Hash)), sizeof(SHA1Hash)) != 0) 
+        {
+            XGDLog(Error) << "Data block hash mismatch: " << in_god_data_paths_[file_index].filename().string() << " block " << (first_block + i) << XGDLog::Endl;
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+bool GoDReader::read_live_header_hash(SHA1Hash& out_hash) 
+{
+    // The Live header sits next to the data directory: <hash> and <hash>.data/Data0000
+    std::filesystem::path header_path = in_god_data_paths_.front().parent_path();
+    header_path.replace_extension();
+
+    std::ifstream header_file(header_path, std::ios::binary);
+    if (!header_file.is_open()) 
+    {
+        return false;
+    }
+
+    header_file.seekg(LIVE_HEADER_MHT_HASH_OFFSET, std::ios::beg);
+    header_file.read(reinterpret_cast<char*>(out_hash.data()), out_hash.size());
+    return !header_file.fail();
+}
+
+bool GoDReader::verify_hashtables() 
+{
+    XGDLog() << "Verifying hash tables" << XGDLog::Endl;
+
+    struct GroupTask 
+    {
+        uint32_t file_index;
+        uint32_t hash_index;
+    };
+
+    std::vector<GroupTask> group_tasks;
+    std::vector<std::vector<SHA1Hash>> sht_hashes(part_infos_.size());
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(part_infos_.size()); ++i) 
+    {
+        sht_hashes[i].resize(part_infos_[i].num_sub_hashtables);
+
+        for (uint32_t j = 0; j < part_infos_[i].num_sub_hashtables; ++j) 
+        {
+            group_tasks.push_back({ i, j });
+        }
+    }
+
+    std::atomic<bool> valid{true};
+    std::atomic<size_t> groups_done{0};
+    std::mutex progress_mutex;
+
+    WorkPool::shared().run(group_tasks.size(), [&](size_t task_index) 
+    {
+        const GroupTask& task = group_tasks[task_index];
+
+        if (!verify_hash_group(task.file_index, task.hash_index, sht_hashes[task.file_index][task.hash_index])) 
+        {
+            valid = false;
+        }
+
+        std::lock_guard<std::mutex> lock(progress_mutex);
+        XGDLog().print_progress(groups_done++, group_tasks.size() - 1);
+    });
+
+    // Master hashtables, each also holds the hash of the next part's master hashtable after its sub hashtable hashes
+    std::vector<unsigned char> mht_buffer(GoD::BLOCK_SIZE);
+    SHA1Hash next_mht_hash;
+
+    for (size_t i = part_infos_.size(); i-- > 0; ) 
+    {
+        if (in_file_.read_part(i, 0, reinterpret_cast<char*>(mht_buffer.data()), mht_buffer.size()) != mht_buffer.size()) 
+        {
+            throw XGDException(ErrCode::FILE_READ, HERE(), in_god_data_paths_[i].string());
+        }
+
+        for (uint32_t j = 0; j < part_infos_[i].num_sub_hashtables; ++j) 
+        {
+            if (std::memcmp(sht_hashes[i][j].data(), mht_buffer.data() + (j * sizeof(SHA1Hash)), sizeof(SHA1Hash)) != 0) 
+            {
+                XGDLog(Error) << "Sub hashtable hash mismatch: " << in_god_data_paths_[i].filename().string() << " sub hashtable " << j << XGDLog::Endl;
+                valid = false;
+            }
+        }
+
+        if (i + 1 < part_infos_.size() && 
+            std::memcmp(next_mht_hash.data(), mht_buffer.data() + (GoD::SHT_PER_MHT * sizeof(SHA1Hash)), sizeof(SHA1Hash)) != 0) 
+        {
+            XGDLog(Error) << "Master hashtable chain mismatch: " << in_god_data_paths_[i].filename().string() << " -> " << in_god_data_paths_[i + 1].filename().string() << XGDLog::Endl;
+            valid = false;
+        }
+
+        HashUtils::sha1(reinterpret_cast<const char*>(mht_buffer.data()), mht_buffer.size(), next_mht_hash.data());
+    }
+
+    SHA1Hash header_hash;
+
+    if (!read_live_header_hash(header_hash)) 
+    {
+        XGDLog() << "Live header not found, skipping its check" << XGDLog::Endl;
+    }
+    else if (header_hash != next_mht_hash) 
+    {
+        XGDLog(Error) << "Live header master hashtable hash mismatch" << XGDLog::Endl;
+        valid = false;
+    }
+
+    return valid;
+}
@@ -2,12 +2,13 @@
 #define _GOD_READER_H_
 
 #include <cstdint>
+#include <array>
 #include <string>
 #include <vector>
 #include <unordered_set>
 #include <filesystem>
-#include <fstream>
 
+#include "SplitFStream/SplitFStream.h"
 #include "Formats/GoD.h"
 #include "ImageReader/ImageReader.h"
 
@@ -17,7 +18,7 @@ public:
     GoDReader(const std::vector<std::filesystem::path>& in_god_directory);
     ~GoDReader() override;
 
-    void read_sector(const uint32_t sector, char* out_buffer) override;
+    void read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer) override;
     void read_bytes(const uint64_t offset, const size_t size, char* out_buffer) override;
 
     uint64_t image_offset() override { return 0; };
@@ -25,23 +26,52 @@ public:
 
     std::string name() override { return in_god_directory_.filename().string(); };
 
+    /*  Checks every data block against its sub hashtable, every sub hashtable against the master hashtable,
+        the master hashtable chain between parts and the Live header. Hash groups from all parts are 
+        checked in parallel. Mismatches are logged, returns false if there were any. */
+    bool verify_hashtables();
+
+protected:
+    void read_sector_uncached(const uint32_t sector, char* out_buffer) override;
+
 private:
-    struct Remap 
+    // Physically contiguous piece of a logical byte range
+    struct Extent 
     {
         uint64_t offset;
+        uint64_t length;
         uint32_t file_index;
     };
 
+    struct PartInfo 
+    {
+        uint64_t first_data_block; // Logical data block the part starts at
+        uint64_t num_data_blocks;
+        uint32_t num_sub_hashtables;
+    };
+
+    using SHA1Hash = std::array<uint8_t, 20>;
+
+    static constexpr uint64_t LIVE_HEADER_MHT_HASH_OFFSET = 0x37D;
+
     std::filesystem::path in_god_directory_;
     std::vector<std::filesystem::path> in_god_data_paths_;
-    std::vector<std::unique_ptr<std::ifstream>> in_files_;
+    split::pread_file in_file_;
 
+    std::vector<PartInfo> part_infos_;
+    uint64_t total_data_blocks_{0};
     uint32_t total_sectors_{0};
 
     void populate_data_files(const std::filesystem::path& in_directory, int search_depth);
+    void build_part_infos();
+
+    // Data blocks are contiguous between sub hashtables, so a range maps to one extent per 204 blocks crossed
+    void map_extents(const uint64_t xiso_offset, const uint64_t size, std::vector<Extent>& out_extents);
+    void read_extents(const uint64_t xiso_offset, const uint64_t size, char* out_buffer);
 
-    Remap remap_sector(uint64_t xiso_sector);
-    Remap remap_offset(uint64_t xiso_offset);
+    // Returns false if any data block in the group doesn't match, out_sht_hash is the group's sub hashtable hash
+    bool verify_hash_group(const uint32_t file_index, const uint32_t hash_index, SHA1Hash& out_sht_hash);
+    bool read_live_header_hash(SHA1Hash& out_hash);
 };
 
 #endif // _GOD_READER_H_
\ No newline at end of file
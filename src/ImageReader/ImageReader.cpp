@@ -1,12 +1,15 @@
 #include <algorithm>
+#include <cstring>
 
 #include "ImageReader/XisoReader/XisoReader.h"
 #include "ImageReader/CCIReader/CCIReader.h"
 #include "ImageReader/GoDReader/GoDReader.h"
 #include "ImageReader/CSOReader/CSOReader.h"
+#include "ImageReader/VirtualXisoReader/VirtualXisoReader.h"
 #include "ImageReader/ImageReader.h"
 #include "XGD.h"
 #include "Utils/StringUtils.h"
+#include "Utils/BufferUtils.h"
 
 std::shared_ptr<ImageReader> ImageReader::create_instance(FileType in_file_type, const std::vector<std::filesystem::path>& paths) 
 {
@@ -20,16 +23,99 @@ std::shared_ptr<ImageReader> ImageReader::create_instance(FileType in_file_type,
             return std::make_shared<GoDReader>(paths);
         case FileType::CSO:
             return std::make_shared<CSOReader>(paths);
+        case FileType::DIR:
+            return std::make_shared<VirtualXisoReader>(paths);
         default:
             throw XGDException(ErrCode::ISO_INVALID, HERE(), "Unsupported ImageReader file type");
     }
 }
 
+ImageReader::~ImageReader() 
+{
+    if (sector_cache_.enabled()) 
+    {
+        SectorCache::Stats stats = sector_cache_.stats();
+        XGDLog(Debug) << "Sector cache hits: " << stats.hits << ", misses: " << stats.misses << XGDLog::Endl;
+    }
+}
+
+void ImageReader::set_sector_cache_size(const size_t num_sectors) 
+{
+    sector_cache_.resize(num_sectors);
+}
+
+void ImageReader::read_sector(const uint32_t sector, char* out_buffer) 
+{
+    if (!sector_cache_.enabled()) 
+    {
+        read_sector_uncached(sector, out_buffer);
+        return;
+    }
+
+    if (!sector_cache_.get(sector, out_buffer)) 
+    {
+        read_sector_uncached(sector, out_buffer);
+        sector_cache_.put(sector, out_buffer);
+    }
+}
+
+void ImageReader::read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer) 
+{
+    for (uint32_t i = 0; i < count; ++i) 
+    {
+        read_sector_uncached(start_sector + i, out_buffer + (static_cast<size_t>(i) * Xiso::SECTOR_SIZE));
+    }
+}
+
+void ImageReader::read_bytes(const uint64_t offset, const size_t size, char* out_buffer) 
+{
+    const size_t bulk_sectors = XGD::BUFFER_SIZE / Xiso::SECTOR_SIZE;
+
+    uint32_t current_sector = static_cast<uint32_t>(offset / Xiso::SECTOR_SIZE);
+    size_t position_in_sector = offset % Xiso::SECTOR_SIZE;
+    size_t bytes_copied = 0;
+
+    std::vector<char> buffer(Xiso::SECTOR_SIZE);
+
+    while (bytes_copied < size) 
+    {
+        size_t whole_sectors = (size - bytes_copied) / Xiso::SECTOR_SIZE;
+
+        // Large aligned runs skip the cache and go straight to the bulk path
+        if (position_in_sector == 0 && whole_sectors >= bulk_sectors) 
+        {
+            read_sectors(current_sector, static_cast<uint32_t>(whole_sectors), out_buffer + bytes_copied);
+
+            current_sector += static_cast<uint32_t>(whole_sectors);
+            bytes_copied += whole_sectors * Xiso::SECTOR_SIZE;
+            continue;
+        }
+
+        size_t copy_size = std::min(size - bytes_copied, Xiso::SECTOR_SIZE - position_in_sector);
+
+        read_sector(current_sector++, buffer.data());
+        std::memcpy(out_buffer + bytes_copied, buffer.data() + position_in_sector, copy_size);
+
+        bytes_copied += copy_size;
+        position_in_sector = 0;
+    }
+}
+
+ImageReader::Span ImageReader::span_sectors(const uint32_t sector, const uint32_t count) 
+{
+    return span_bytes(static_cast<uint64_t>(sector) * Xiso::SECTOR_SIZE, static_cast<size_t>(count) * Xiso::SECTOR_SIZE);
+}
+
+void ImageReader::read_lz4_blocks(const uint32_t start_sector, const uint32_t count, std::vector<char>& out_buffer, std::vector<LZ4Block>& out_blocks)
+{
+    throw XGDException(ErrCode::MISC, HERE(), "Input image isn't stored as LZ4 blocks");
+}
+
 const std::vector<Xiso::DirectoryEntry>& ImageReader::directory_entries() 
 {
-    if (directory_entries_.empty()) 
+    if (!directory_tree_parsed_) 
     {
-        populate_directory_entries(false);
+        parse_directory_tree();
     }
     return directory_entries_;
 }
@@ -38,11 +124,97 @@ const Xiso::DirectoryEntry& ImageReader::executable_entry()
 {
     if (executable_entry_.path.empty()) 
     {
-        populate_directory_entries(true);
+        // Only the root directory is searched, so there's no need to parse the whole tree
+        std::vector<Xiso::DirectoryEntry> root_entries;
+        parse_directory_table(root_directory_entry(), root_entries);
+
+        for (const auto& entry : root_entries) 
+        {
+            if (!(entry.header.attributes & Xiso::ATTRIBUTE_DIRECTORY) && entry.header.file_size > 0 &&
+                (StringUtils::case_insensitive_search(entry.filename, "default.xex") ||
+                 StringUtils::case_insensitive_search(entry.filename, "default.xbe"))) 
+            {
+                executable_entry_ = entry;
+                break;
+            }
+        }
+
+        if (executable_entry_.path.empty()) 
+        {
+            throw XGDException(ErrCode::MISC, HERE(), "No executable found in image");
+        }
     }
     return executable_entry_;
 }
 
+const Xiso::DirectoryEntry* ImageReader::find_entry(const std::filesystem::path& path) 
+{
+    const Xiso::DirectoryEntry* current_entry = nullptr;
+    std::string current_key;
+
+    index_directory(root_directory_entry(), "");
+
+    for (const auto& component : path.relative_path()) 
+    {
+        if (component.empty()) 
+        {
+            continue;
+        }
+
+        // Step into the parent's table only once the path is known to go through it
+        if (current_entry) 
+        {
+            if (!(current_entry->header.attributes & Xiso::ATTRIBUTE_DIRECTORY)) 
+            {
+                return nullptr;
+            }
+            index_directory(*current_entry, current_key);
+        }
+
+        current_key += (current_key.empty() ? "" : "/") + StringUtils::to_lower(component.string());
+
+        auto it = entry_index_.find(current_key);
+        if (it == entry_index_.end()) 
+        {
+            return nullptr;
+        }
+        current_entry = &it->second;
+    }
+    return current_entry;
+}
+
+void ImageReader::index_directory(const Xiso::DirectoryEntry& dir_entry, const std::string& dir_key) 
+{
+    if (!indexed_directories_.insert(dir_key).second) 
+    {
+        return;
+    }
+
+    std::vector<Xiso::DirectoryEntry> table_entries;
+    parse_directory_table(dir_entry, table_entries);
+
+    for (auto& entry : table_entries) 
+    {
+        std::string key = (dir_key.empty() ? "" : dir_key + "/") + StringUtils::to_lower(entry.filename);
+        entry_index_.emplace(std::move(key), std::move(entry));
+    }
+}
+
+const Xiso::DirectoryEntry& ImageReader::root_directory_entry() 
+{
+    if (!root_entry_loaded_) 
+    {
+        read_bytes(image_offset() + Xiso::MAGIC_OFFSET + Xiso::MAGIC_DATA_LEN, sizeof(uint32_t) * 2, reinterpret_cast<char*>(&root_entry_.header.start_sector));
+
+        root_entry_.header.attributes = Xiso::ATTRIBUTE_DIRECTORY;
+        root_entry_.offset = 0;
+        root_entry_.position = static_cast<uint64_t>(root_entry_.header.start_sector) * Xiso::SECTOR_SIZE;
+        root_entry_.path = "";
+        root_entry_loaded_ = true;
+    }
+    return root_entry_;
+}
+
 Platform ImageReader::platform() 
 {
     if (platform_ == Platform::UNKNOWN) 
@@ -89,231 +261,215 @@ uint64_t ImageReader::total_file_bytes()
 
 uint32_t ImageReader::max_data_sector() 
 {
-    if (data_sectors_.empty()) 
-    {
-        data_sectors();
-    }
+    data_sectors();
     return max_data_sector_;
 }
 
-const std::unordered_set<uint32_t>& ImageReader::data_sectors() 
+const SectorSet& ImageReader::data_sectors() 
 {
-    if (!data_sectors_.empty()) 
+    if (data_sectors_complete_) 
     {
         return data_sectors_;
     }
 
-    populate_data_sectors();
+    // Entries may have come from load_metadata without the sectors the tree walk collects
+    if (!directory_tree_parsed_ || data_sectors_.empty()) 
+    {
+        parse_directory_tree();
+    }
 
-    auto max_data_sector_it = std::max_element(data_sectors_.begin(), data_sectors_.end());
-    max_data_sector_ = (max_data_sector_it != data_sectors_.end()) ? *max_data_sector_it : 0;
+    max_data_sector_ = data_sectors_.max();
 
-    std::unordered_set<uint32_t> security_sectors;
+    SectorSet security_sectors;
 
     if (platform() == Platform::OGX && get_security_sectors(security_sectors)) 
     {
-        for (const auto& sector : security_sectors) 
-        {
-            data_sectors_.insert(sector);
-        }
+        data_sectors_.insert(security_sectors);
     }
     else //Image is either Xbox 360 or already scrubbed/rewritten
     {
-        for (uint32_t i = static_cast<uint32_t>(image_offset() / Xiso::SECTOR_SIZE); i < max_data_sector_; ++i) 
-        {
-            data_sectors_.insert(i);
-        } 
+        data_sectors_.insert(static_cast<uint32_t>(image_offset() / Xiso::SECTOR_SIZE), max_data_sector_);
     }
+
+    data_sectors_complete_ = true;
     return data_sectors_;
 }
 
-void ImageReader::populate_directory_entries(bool exe_only) 
+ImageReader::Metadata ImageReader::metadata() const 
 {
-    directory_entries_.clear();
+    Metadata metadata;
+
+    if (directory_tree_parsed_) 
+    {
+        metadata.has_directory_entries = true;
+        metadata.directory_entries = directory_entries_;
+    }
+    if (data_sectors_complete_) 
+    {
+        metadata.has_data_sectors = true;
+        metadata.data_sectors = data_sectors_;
+        metadata.max_data_sector = max_data_sector_;
+    }
+    return metadata;
+}
+
+void ImageReader::load_metadata(const Metadata& metadata) 
+{
+    if (metadata.has_directory_entries) 
+    {
+        directory_entries_ = metadata.directory_entries;
+        directory_tree_parsed_ = true;
+    }
+    if (metadata.has_data_sectors) 
+    {
+        data_sectors_ = metadata.data_sectors;
+        max_data_sector_ = metadata.max_data_sector;
+        data_sectors_complete_ = true;
+    }
+}
+
+const char* ImageReader::read_directory_table(const uint64_t position, const uint32_t size, std::vector<char>& buffer) 
+{
+    Span span = span_bytes(image_offset() + position, size);
+    if (span) 
+    {
+        return span.data;
+    }
+
+    buffer.resize(size);
+    read_bytes(image_offset() + position, size, buffer.data());
+    return buffer.data();
+}
 
-    Xiso::DirectoryEntry root_entry;
-    read_bytes(image_offset() + Xiso::MAGIC_OFFSET + Xiso::MAGIC_DATA_LEN, sizeof(uint32_t) * 2, reinterpret_cast<char*>(&root_entry.header.start_sector));
+void ImageReader::parse_directory_table(const Xiso::DirectoryEntry& dir_entry, std::vector<Xiso::DirectoryEntry>& out_entries) 
+{
+    const uint32_t table_size = dir_entry.header.file_size;
 
-    root_entry.offset = 0;
-    root_entry.position = static_cast<uint64_t>(root_entry.header.start_sector) * Xiso::SECTOR_SIZE;
-    root_entry.path = "";
+    if (table_size == 0) 
+    {
+        return;
+    }
 
-    std::vector<Xiso::DirectoryEntry> unprocessed_entries;
-    unprocessed_entries.push_back(root_entry);
+    std::vector<char> table_buffer;
+    const char* table = read_directory_table(dir_entry.position, table_size, table_buffer);
 
-    while (!unprocessed_entries.empty())
+    // Nodes are visited breadth first from the table's root, each one at most once
+    std::vector<uint16_t> node_offsets{ 0 };
+    std::vector<bool> visited_nodes((table_size / sizeof(uint32_t)) + 1, false);
+
+    for (size_t node_index = 0; node_index < node_offsets.size(); ++node_index) 
     {
-        Xiso::DirectoryEntry current_entry = unprocessed_entries.front();
-        unprocessed_entries.erase(unprocessed_entries.begin());
+        uint16_t node_offset = node_offsets[node_index];
+        uint64_t entry_offset = static_cast<uint64_t>(node_offset) * sizeof(uint32_t);
 
-        if ((current_entry.offset * sizeof(uint32_t)) >= current_entry.header.file_size) 
+        if (entry_offset >= table_size || visited_nodes[node_offset]) 
         {
             continue;
         }
+        visited_nodes[node_offset] = true;
 
-        uint64_t current_position = image_offset() + current_entry.position + (current_entry.offset * sizeof(uint32_t));
+        if (entry_offset + sizeof(Xiso::DirectoryEntry::Header) > table_size) 
+        {
+            throw XGDException(ErrCode::ISO_INVALID, HERE(), "Directory entry out of bounds");
+        }
 
         Xiso::DirectoryEntry read_entry;
-        read_bytes(current_position, sizeof(Xiso::DirectoryEntry::Header), reinterpret_cast<char*>(&read_entry.header));
+        std::memcpy(&read_entry.header, table + entry_offset, sizeof(Xiso::DirectoryEntry::Header));
 
-        std::vector<char> filename_buffer(std::min(read_entry.header.name_length, static_cast<uint8_t>(UINT8_MAX)));
-        read_bytes(current_position + sizeof(Xiso::DirectoryEntry::Header), filename_buffer.size(), filename_buffer.data());
-        read_entry.filename.assign(filename_buffer.data(), filename_buffer.size());
-
-        if (read_entry.header.left_offset == Xiso::PAD_BYTE)
+        if (read_entry.header.left_offset == Xiso::PAD_SHORT) 
         {
             continue;
         }
 
-        if (read_entry.header.left_offset != 0)
+        if (entry_offset + sizeof(Xiso::DirectoryEntry::Header) + read_entry.header.name_length > table_size) 
         {
-            current_entry.offset = static_cast<uint64_t>(read_entry.header.left_offset);
-            unprocessed_entries.push_back(current_entry);
+            throw XGDException(ErrCode::ISO_INVALID, HERE(), "Directory entry out of bounds");
         }
 
-        if (exe_only)
-        {
-            if (!(read_entry.header.attributes & Xiso::ATTRIBUTE_DIRECTORY) && read_entry.header.file_size > 0)
-            {
-                if (StringUtils::case_insensitive_search(read_entry.filename, "default.xex") ||
-                    StringUtils::case_insensitive_search(read_entry.filename, "default.xbe"))
-                {
-                    read_entry.path = read_entry.filename;
-                    executable_entry_ = read_entry;
-                    return;
-                } 
-            }
-        }
-        else
-        {
-            if (read_entry.header.attributes & Xiso::ATTRIBUTE_DIRECTORY)
-            {
-                Xiso::DirectoryEntry dir_entry = read_entry;
-                dir_entry.offset = 0;
-                dir_entry.position = static_cast<uint64_t>(read_entry.header.start_sector) * Xiso::SECTOR_SIZE;
-                dir_entry.path = current_entry.path / read_entry.filename;
-                directory_entries_.push_back(dir_entry);
+        read_entry.filename.assign(table + entry_offset + sizeof(Xiso::DirectoryEntry::Header), read_entry.header.name_length);
+        read_entry.offset = 0;
+        read_entry.position = static_cast<uint64_t>(read_entry.header.start_sector) * Xiso::SECTOR_SIZE;
+        read_entry.path = dir_entry.path / read_entry.filename;
 
-                if (read_entry.header.file_size > 0) 
-                {
-                    unprocessed_entries.push_back(dir_entry);
-                }  
-            }
-            else if (read_entry.header.file_size > 0) 
-            {
-                read_entry.path = current_entry.path / read_entry.filename;
-                directory_entries_.push_back(read_entry);
-            }
+        if (read_entry.header.left_offset != 0) 
+        {
+            node_offsets.push_back(read_entry.header.left_offset);
         }
-
         if (read_entry.header.right_offset != 0) 
         {
-            current_entry.offset = static_cast<uint64_t>(read_entry.header.right_offset);
-            unprocessed_entries.push_back(current_entry);
+            node_offsets.push_back(read_entry.header.right_offset);
         }
-    }
 
-    if (exe_only) 
-    {
-        throw XGDException(ErrCode::MISC, HERE(), "No executable found in GoD image");
+        out_entries.push_back(std::move(read_entry));
     }
-
-    std::sort(directory_entries_.begin(), directory_entries_.end(), [](const Xiso::DirectoryEntry& a, const Xiso::DirectoryEntry& b) 
-    {
-        bool a_is_dir = a.header.attributes & Xiso::ATTRIBUTE_DIRECTORY;
-        bool b_is_dir = b.header.attributes & Xiso::ATTRIBUTE_DIRECTORY;
-        
-        if (a_is_dir != b_is_dir) 
-        {
-            return a_is_dir > b_is_dir;
-        }
-
-        return a.path < b.path;
-    });
 }
 
-void ImageReader::populate_data_sectors() 
+void ImageReader::parse_directory_tree() 
 {
+    directory_entries_.clear();
     data_sectors_.clear();
 
     uint32_t sector_offset = static_cast<uint32_t>(image_offset() / Xiso::SECTOR_SIZE);
     uint32_t header_sector = sector_offset + static_cast<uint32_t>(Xiso::MAGIC_OFFSET / Xiso::SECTOR_SIZE);
 
-    data_sectors_.insert(header_sector);
-    data_sectors_.insert(header_sector + 1);
+    data_sectors_.insert(header_sector, header_sector + 2);
 
-    Xiso::DirectoryEntry root_entry;
-    read_bytes(image_offset() + Xiso::MAGIC_OFFSET + Xiso::MAGIC_DATA_LEN, sizeof(uint32_t) * 2, reinterpret_cast<char*>(&root_entry.header.start_sector));
+    // Directories are walked breadth first, each table is read once and its nodes parsed from memory
+    std::vector<Xiso::DirectoryEntry> directories{ root_directory_entry() };
+    std::vector<Xiso::DirectoryEntry> table_entries;
 
-    root_entry.offset = 0;
-    root_entry.position = static_cast<uint64_t>(root_entry.header.start_sector) * Xiso::SECTOR_SIZE;
-
-    std::vector<Xiso::DirectoryEntry> unprocessed_entries;
-    unprocessed_entries.push_back(root_entry);
-
-    XGDLog() << "Reading data sectors" << XGDLog::Endl;
-
-    while (!unprocessed_entries.empty()) 
+    for (size_t dir_index = 0; dir_index < directories.size(); ++dir_index) 
     {
-        Xiso::DirectoryEntry current_entry = unprocessed_entries.front();
-        unprocessed_entries.erase(unprocessed_entries.begin());
+        const Xiso::DirectoryEntry dir_entry = directories[dir_index];
 
-        uint64_t current_position = image_offset() + current_entry.position + (current_entry.offset * sizeof(uint32_t));
-
-        for (auto i = current_position >> 11; i < (current_position >> 11) + ((current_entry.header.file_size - (current_entry.offset * 4) + 2047) >> 11); i++) 
-        {
-            data_sectors_.insert(static_cast<uint32_t>(i));
-        }
-
-        if ((current_entry.offset * 4) >= current_entry.header.file_size) 
+        if (dir_entry.header.file_size == 0) 
         {
             continue;
         }
 
-        Xiso::DirectoryEntry read_entry;
-        read_bytes(current_position, sizeof(Xiso::DirectoryEntry::Header), reinterpret_cast<char*>(&read_entry.header));
-
-        if (read_entry.header.left_offset == Xiso::PAD_SHORT) 
-        {
-            continue;
-        }
+        uint32_t table_sector = sector_offset + static_cast<uint32_t>(dir_entry.position / Xiso::SECTOR_SIZE);
+        data_sectors_.insert(table_sector, table_sector + ((dir_entry.header.file_size + Xiso::SECTOR_SIZE - 1) / Xiso::SECTOR_SIZE));
 
-        if (read_entry.header.left_offset != 0) 
-        {
-            current_entry.offset = static_cast<uint64_t>(read_entry.header.left_offset);
-            unprocessed_entries.push_back(current_entry);
-        }
+        table_entries.clear();
+        parse_directory_table(dir_entry, table_entries);
 
-        if ((read_entry.header.attributes & Xiso::ATTRIBUTE_DIRECTORY) != 0) 
+        for (auto& entry : table_entries) 
         {
-            if (read_entry.header.file_size > 0) 
+            if (entry.header.attributes & Xiso::ATTRIBUTE_DIRECTORY) 
             {
-                Xiso::DirectoryEntry dir_entry = read_entry;
-                dir_entry.offset = 0;
-                dir_entry.position = static_cast<uint64_t>(read_entry.header.start_sector) * Xiso::SECTOR_SIZE;
-                unprocessed_entries.push_back(dir_entry);
-            }
-        } 
-        else 
-        {
-            if (read_entry.header.file_size > 0) 
-            {
-                for (auto i = sector_offset + read_entry.header.start_sector; i < sector_offset + read_entry.header.start_sector + ((read_entry.header.file_size + Xiso::SECTOR_SIZE - 1) / Xiso::SECTOR_SIZE); i++) 
+                if (entry.header.file_size > 0) 
                 {
-                    data_sectors_.insert(static_cast<uint32_t>(i));
+                    directories.push_back(entry);
                 }
+                directory_entries_.push_back(std::move(entry));
+            } 
+            else if (entry.header.file_size > 0) 
+            {
+                uint32_t file_sector = sector_offset + entry.header.start_sector;
+                data_sectors_.insert(file_sector, file_sector + ((entry.header.file_size + Xiso::SECTOR_SIZE - 1) / Xiso::SECTOR_SIZE));
+
+                directory_entries_.push_back(std::move(entry));
             }
         }
+    }
 
-        if (read_entry.header.right_offset != 0) 
+    std::sort(directory_entries_.begin(), directory_entries_.end(), [](const Xiso::DirectoryEntry& a, const Xiso::DirectoryEntry& b) 
+    {
+        bool a_is_dir = a.header.attributes & Xiso::ATTRIBUTE_DIRECTORY;
+        bool b_is_dir = b.header.attributes & Xiso::ATTRIBUTE_DIRECTORY;
+        
+        if (a_is_dir != b_is_dir) 
         {
-            current_entry.offset = static_cast<uint64_t>(read_entry.header.right_offset);
-            unprocessed_entries.push_back(current_entry);
+            return a_is_dir > b_is_dir;
         }
-    }
+
+        return a.path < b.path;
+    });
+
+    directory_tree_parsed_ = true;
 }
 
-bool ImageReader::get_security_sectors(std::unordered_set<uint32_t>& out_security_sectors) 
+bool ImageReader::get_security_sectors(SectorSet& out_security_sectors) 
 {
     out_security_sectors.clear();
 
@@ -328,51 +484,71 @@ bool ImageReader::get_security_sectors(std::unordered_set<uint32_t>& out_securit
     uint32_t start = 0;
     const uint32_t end_sector = 0x345B60;
 
-    std::vector<char> sector_buffer(Xiso::SECTOR_SIZE);
+    // Sectors are read and zero checked in large chunks, then run through the same state machine one by one
+    const uint32_t chunk_sectors = static_cast<uint32_t>(XGD::SCAN_BUFFER_SIZE / Xiso::SECTOR_SIZE);
+    const uint32_t sectors_per_task = 64;
+
+    std::vector<char> chunk_buffer;
+    std::vector<uint8_t> empty_sectors(chunk_sectors);
 
     XGDLog() << "Reading security sectors" << XGDLog::Endl;
-    
-    for (uint32_t sector_index = 0; sector_index <= end_sector; ++sector_index) 
+
+    for (uint32_t chunk_start = 0; chunk_start <= end_sector; chunk_start += chunk_sectors) 
     {
-        uint32_t current_sector = sector_offset + sector_index;
-        read_sector(current_sector, sector_buffer.data());
+        uint32_t chunk_count = std::min(chunk_sectors, (end_sector + 1) - chunk_start);
+        const char* chunk_data = nullptr;
 
-        bool is_data_sector = data_sectors_.find(current_sector) != data_sectors_.end();
-        bool is_empty_sector = true;
-        for (auto& byte : sector_buffer) 
+        Span span = span_sectors(sector_offset + chunk_start, chunk_count);
+        if (span) 
         {
-            if (byte != 0) 
-            {
-                is_empty_sector = false;
-                break;
-            }
+            chunk_data = span.data;
+        } 
+        else 
+        {
+            chunk_buffer.resize(static_cast<size_t>(chunk_sectors) * Xiso::SECTOR_SIZE);
+            read_sectors(sector_offset + chunk_start, chunk_count, chunk_buffer.data());
+            chunk_data = chunk_buffer.data();
         }
 
-        if (is_empty_sector && !flag && !is_data_sector) 
+        WorkPool::shared().run((chunk_count + sectors_per_task - 1) / sectors_per_task, [&](size_t task_idx) 
         {
-            start = current_sector;
-            flag = true;
-        } 
-        else if (!is_empty_sector && flag) 
+            uint32_t task_start = static_cast<uint32_t>(task_idx) * sectors_per_task;
+            uint32_t task_end = std::min(chunk_count, task_start + sectors_per_task);
+
+            for (uint32_t i = task_start; i < task_end; ++i) 
+            {
+                empty_sectors[i] = BufferUtils::is_zero(chunk_data + (static_cast<size_t>(i) * Xiso::SECTOR_SIZE), Xiso::SECTOR_SIZE);
+            }
+        });
+
+        for (uint32_t i = 0; i < chunk_count; ++i) 
         {
-            uint32_t end = current_sector - 1;
-            flag = false;
+            uint32_t current_sector = sector_offset + chunk_start + i;
+            bool is_empty_sector = empty_sectors[i] != 0;
 
-            if (end - start == 0xFFF) 
+            if (is_empty_sector && !flag && !data_sectors_.contains(current_sector)) 
             {
-                for (uint32_t i = start; i <= end; ++i) 
-                {
-                    out_security_sectors.insert(i);
-                }
+                start = current_sector;
+                flag = true;
             } 
-            else if (compare_mode && (end - start) > 0xFFF) 
+            else if (!is_empty_sector && flag) 
             {
-                XGDLog().print_progress(100, 100);
-                return false;
+                uint32_t end = current_sector - 1;
+                flag = false;
+
+                if (end - start == 0xFFF) 
+                {
+                    out_security_sectors.insert(start, end + 1);
+                } 
+                else if (compare_mode && (end - start) > 0xFFF) 
+                {
+                    XGDLog().print_progress(100, 100);
+                    return false;
+                }
             }
         }
 
-        XGDLog().print_progress(sector_index, end_sector);
+        XGDLog().print_progress(chunk_start + chunk_count - 1, end_sector);
     }
     return true;
-}
\ No newline at end of file
+}
@@ -4,24 +4,79 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
+#include <filesystem>
 
 #include "Formats/Xiso.h"
 #include "InputHelper/Types.h"
+#include "ImageReader/SectorCache/SectorCache.h"
+#include "ImageReader/SectorSet/SectorSet.h"
+#include "WorkPool/WorkPool.h"
 
 /*  Each derived class implements its own override methods for reading the filetype it's responsible for,
     ImageReader's virtual read_ methods should all produce the same results no matter the derived class.
     Derived classes all take the same constructor params, a vector of file paths to accommodate split 
-    ISO/CCI/CSO images, for GoD, provide its root directory. */
+    ISO/CCI/CSO images, for GoD, provide its root directory, for a directory of files (VirtualXisoReader), the directory. 
+    read_sector checks the sector cache before calling the derived class's read_sector_uncached, 
+    read_bytes is assembled from read_sector unless the derived class has a faster path. 
+    read_sector, read_sectors and read_bytes are safe to call from multiple threads, derived classes 
+    use positional reads and keep no per-call state in members. The lazily populated metadata 
+    (directory_entries, data_sectors etc.) is not, so fetch it before spawning workers. */
 class ImageReader 
 {
 public:
-    virtual ~ImageReader() = default;
+    /*  A read-only view of image bytes owned by the reader, 
+        valid for as long as the reader is alive. */
+    struct Span
+    {
+        const char* data{nullptr};
+        size_t size{0};
+
+        explicit operator bool() const { return data != nullptr; }
+    };
+
+    /*  A sector as stored in a CSO or CCI image, a raw LZ4 block if compressed, the sector itself if not.
+        offset is into the buffer the block was read into. */
+    struct LZ4Block
+    {
+        size_t offset{0};
+        uint32_t size{0};
+        bool compressed{false};
+    };
+
+    /*  Parsed metadata that's expensive to compute, for persisting between runs. 
+        Parts that haven't been computed yet are flagged as missing. */
+    struct Metadata
+    {
+        bool has_directory_entries{false};
+        std::vector<Xiso::DirectoryEntry> directory_entries;
+
+        bool has_data_sectors{false};
+        SectorSet data_sectors; // Includes security sectors
+        uint32_t max_data_sector{0};
+    };
+
+    virtual ~ImageReader();
 
     static std::shared_ptr<ImageReader> create_instance(FileType in_file_type, const std::vector<std::filesystem::path>& in_paths);
 
-    virtual void read_sector(const uint32_t sector, char* out_buffer) = 0;
-    virtual void read_bytes(const uint64_t offset, const size_t size, char* out_buffer) = 0;
+    void read_sector(const uint32_t sector, char* out_buffer);
+    virtual void read_bytes(const uint64_t offset, const size_t size, char* out_buffer);
+
+    /*  Reads count consecutive sectors into out_buffer, derived classes override this with a native 
+        bulk read. Bypasses the sector cache since bulk reads are rarely repeated. */
+    virtual void read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer);
+
+    /*  Zero-copy reads, derived classes that can expose their data directly override span_bytes, 
+        an empty Span is returned otherwise and callers should fall back to read_sector/read_bytes. */
+    virtual Span span_bytes(const uint64_t offset, const size_t size) { return Span(); };
+    Span span_sectors(const uint32_t sector, const uint32_t count);
+
+    /*  Reads the stored blocks of count consecutive sectors without decoding them, so they can be copied 
+        between compressed formats. Only for readers that return their format from lz4_block_format. */
+    virtual FileType lz4_block_format() { return FileType::UNKNOWN; };
+    virtual void read_lz4_blocks(const uint32_t start_sector, const uint32_t count, std::vector<char>& out_buffer, std::vector<LZ4Block>& out_blocks);
 
     virtual uint64_t image_offset() = 0;
     virtual uint32_t total_sectors() = 0;
@@ -29,26 +84,56 @@ public:
 
     const std::vector<Xiso::DirectoryEntry>& directory_entries();
     const Xiso::DirectoryEntry& executable_entry();
-    const std::unordered_set<uint32_t>& data_sectors();
+    const SectorSet& data_sectors();
+
+    /*  Case insensitive lookup of an entry by its path relative to the image root, nullptr if it doesn't exist. 
+        Only the directory tables along the path are read, and each one is read at most once. */
+    const Xiso::DirectoryEntry* find_entry(const std::filesystem::path& path);
 
     uint32_t max_data_sector();
     uint64_t total_file_bytes();
     Platform platform();
     Xiso::FileTime file_time();
 
+    Metadata metadata() const;
+    void load_metadata(const Metadata& metadata);
+
+    // Capacity in sectors, 0 disables the cache
+    void set_sector_cache_size(const size_t num_sectors);
+    SectorCache::Stats sector_cache_stats() const { return sector_cache_.stats(); };
+
+protected:
+    virtual void read_sector_uncached(const uint32_t sector, char* out_buffer) = 0;
+
 private:
+    SectorCache sector_cache_;
+
     std::vector<Xiso::DirectoryEntry> directory_entries_;
     Xiso::DirectoryEntry executable_entry_;
-    std::unordered_set<uint32_t> data_sectors_;
+    Xiso::DirectoryEntry root_entry_;
+    bool root_entry_loaded_{false};
+
+    // Lowercase path -> entry, filled one directory table at a time by find_entry
+    std::unordered_map<std::string, Xiso::DirectoryEntry> entry_index_;
+    std::unordered_set<std::string> indexed_directories_;
+    SectorSet data_sectors_;
+
+    bool directory_tree_parsed_{false};
+    bool data_sectors_complete_{false};
 
     uint32_t max_data_sector_{0};
     uint64_t total_file_bytes_{0};
     Platform platform_{Platform::UNKNOWN};
     Xiso::FileTime file_time_{};
 
-    void populate_directory_entries(bool exe_only);
-    void populate_data_sectors();
-    bool get_security_sectors(std::unordered_set<uint32_t>& out_security_sectors);
+    /*  Single pass over the directory tree, fills directory_entries_ 
+        and data_sectors_ with everything but the security sectors. */
+    void parse_directory_tree();
+    void parse_directory_table(const Xiso::DirectoryEntry& dir_entry, std::vector<Xiso::DirectoryEntry>& out_entries);
+    void index_directory(const Xiso::DirectoryEntry& dir_entry, const std::string& dir_key);
+    const Xiso::DirectoryEntry& root_directory_entry();
+    const char* read_directory_table(const uint64_t position, const uint32_t size, std::vector<char>& buffer);
+    bool get_security_sectors(SectorSet& out_security_sectors);
 };
 
 #endif // _IMAGE_READER_H_
\ No newline at end of file
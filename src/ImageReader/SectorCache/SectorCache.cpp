@@ -0,0 +1,91 @@
+#include <cstring>
+#include <algorithm>
+
+#include "Formats/Xiso.h"
+#include "ImageReader/SectorCache/SectorCache.h"
+
+void SectorCache::resize(const size_t capacity)
+{
+    shards_.clear();
+    capacity_ = capacity;
+    hits_ = 0;
+    misses_ = 0;
+
+    if (capacity_ == 0)
+    {
+        return;
+    }
+
+    size_t num_shards = std::min(capacity_, MAX_SHARDS);
+    size_t shard_capacity = (capacity_ + num_shards - 1) / num_shards;
+
+    for (size_t i = 0; i < num_shards; ++i)
+    {
+        shards_.push_back(std::make_unique<Shard>());
+        shards_.back()->capacity = shard_capacity;
+        shards_.back()->slots.resize(shard_capacity * Xiso::SECTOR_SIZE);
+        shards_.back()->entries.reserve(shard_capacity);
+    }
+}
+
+void SectorCache::clear()
+{
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->entries.clear();
+    }
+}
+
+bool SectorCache::get(const uint32_t sector, char* out_buffer)
+{
+    Shard& current_shard = shard(sector);
+    std::lock_guard<std::mutex> lock(current_shard.mutex);
+
+    auto it = current_shard.entries.find(sector);
+    if (it == current_shard.entries.end())
+    {
+        misses_++;
+        return false;
+    }
+
+    current_shard.lru.splice(current_shard.lru.begin(), current_shard.lru, it->second);
+    std::memcpy(out_buffer, current_shard.slots.data() + (it->second->second * Xiso::SECTOR_SIZE), Xiso::SECTOR_SIZE);
+
+    hits_++;
+    return true;
+}
+
+void SectorCache::put(const uint32_t sector, const char* in_buffer)
+{
+    Shard& current_shard = shard(sector);
+    std::lock_guard<std::mutex> lock(current_shard.mutex);
+
+    size_t slot;
+    auto it = current_shard.entries.find(sector);
+
+    if (it != current_shard.entries.end())
+    {
+        current_shard.lru.splice(current_shard.lru.begin(), current_shard.lru, it->second);
+        slot = it->second->second;
+    }
+    else if (current_shard.lru.size() < current_shard.capacity)
+    {
+        slot = current_shard.lru.size();
+        current_shard.lru.emplace_front(sector, slot);
+        current_shard.entries[sector] = current_shard.lru.begin();
+    }
+    else // Evict the least recently used sector and reuse its slot
+    {
+        auto last = std::prev(current_shard.lru.end());
+        current_shard.entries.erase(last->first);
+
+        slot = last->second;
+        last->first = sector;
+        current_shard.lru.splice(current_shard.lru.begin(), current_shard.lru, last);
+        current_shard.entries[sector] = current_shard.lru.begin();
+    }
+
+    std::memcpy(current_shard.slots.data() + (slot * Xiso::SECTOR_SIZE), in_buffer, Xiso::SECTOR_SIZE);
+}
@@ -0,0 +1,60 @@
+#ifndef _SECTOR_CACHE_H_
+#define _SECTOR_CACHE_H_
+
+#include <cstdint>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+/*  LRU cache of decoded sectors, split into independently locked shards so
+    concurrent readers only contend when they touch the same shard.
+    resize() is not thread safe and should be called before the cache is used. */
+class SectorCache
+{
+public:
+    struct Stats
+    {
+        uint64_t hits{0};
+        uint64_t misses{0};
+    };
+
+    static constexpr size_t DEFAULT_CAPACITY = 4096; // Sectors, 8MB
+    static constexpr size_t MAX_SHARDS = 16;
+
+    SectorCache() = default;
+
+    void resize(const size_t capacity);
+    void clear();
+
+    bool get(const uint32_t sector, char* out_buffer);
+    void put(const uint32_t sector, const char* in_buffer);
+
+    size_t capacity() const { return capacity_; };
+    bool enabled() const { return capacity_ > 0; };
+    Stats stats() const { return { hits_.load(), misses_.load() }; };
+
+private:
+    using LruList = std::list<std::pair<uint32_t, size_t>>; // Sector, slot index
+
+    struct Shard
+    {
+        std::mutex mutex;
+        LruList lru;
+        std::unordered_map<uint32_t, LruList::iterator> entries;
+        std::vector<char> slots;
+        size_t capacity{0};
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    size_t capacity_{0};
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+
+    Shard& shard(const uint32_t sector) { return *shards_[sector % shards_.size()]; };
+};
+
+#endif // _SECTOR_CACHE_H_
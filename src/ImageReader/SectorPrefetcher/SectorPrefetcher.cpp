@@ -0,0 +1,136 @@
+#include <algorithm>
+
+#include "Formats/Xiso.h"
+#include "ImageReader/SectorPrefetcher/SectorPrefetcher.h"
+
+SectorPrefetcher::SectorPrefetcher(const uint32_t start_sector, const uint32_t end_sector, const uint32_t batch_sectors, const size_t depth_sectors, ReadFunction read_function)
+    :   end_sector_(end_sector), 
+        batch_sectors_(std::max(batch_sectors, static_cast<uint32_t>(1))), 
+        read_function_(std::move(read_function)),
+        next_sector_(start_sector)
+{
+    // One slot is held by the consumer, the rest are filled ahead of it
+    size_t ahead_slots = (depth_sectors + batch_sectors_ - 1) / batch_sectors_;
+    size_t total_batches = (end_sector > start_sector) ? ((end_sector - start_sector) + batch_sectors_ - 1) / batch_sectors_ : 0;
+
+    ahead_slots = std::min(ahead_slots, total_batches);
+
+    slots_.resize(ahead_slots + 1);
+    for (size_t i = 0; i < slots_.size(); ++i)
+    {
+        slots_[i].buffer.resize(static_cast<size_t>(batch_sectors_) * Xiso::SECTOR_SIZE);
+        free_slots_.push_back(i);
+    }
+
+    if (ahead_slots > 0)
+    {
+        read_thread_ = std::thread(&SectorPrefetcher::read_worker, this);
+    }
+}
+
+SectorPrefetcher::~SectorPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_flag_ = true;
+    }
+
+    cv_.notify_all();
+
+    if (read_thread_.joinable())
+    {
+        read_thread_.join();
+    }
+}
+
+bool SectorPrefetcher::next(Batch& out_batch)
+{
+    if (!read_thread_.joinable())
+    {
+        if (next_sector_ >= end_sector_)
+        {
+            return false;
+        }
+
+        Slot& slot = slots_.front();
+        uint32_t count = std::min(end_sector_ - next_sector_, batch_sectors_);
+
+        out_batch = { next_sector_, count, read_function_(next_sector_, count, slot.buffer.data()) };
+        next_sector_ += count;
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (held_slot_ != SIZE_MAX)
+    {
+        free_slots_.push_back(held_slot_);
+        held_slot_ = SIZE_MAX;
+        cv_.notify_all();
+    }
+
+    cv_.wait(lock, [this] { return !ready_slots_.empty() || read_done_ || error_; });
+
+    // Batches read before a failure are still handed out in order
+    if (ready_slots_.empty())
+    {
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+        return false;
+    }
+
+    held_slot_ = ready_slots_.front();
+    ready_slots_.pop_front();
+
+    out_batch = slots_[held_slot_].batch;
+    return true;
+}
+
+void SectorPrefetcher::read_worker()
+{
+    while (true)
+    {
+        size_t slot_index = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            cv_.wait(lock, [this] { return stop_flag_ || !free_slots_.empty(); });
+
+            if (stop_flag_)
+            {
+                return;
+            }
+            if (next_sector_ >= end_sector_)
+            {
+                read_done_ = true;
+                cv_.notify_all();
+                return;
+            }
+
+            slot_index = free_slots_.front();
+            free_slots_.pop_front();
+        }
+
+        Slot& slot = slots_[slot_index];
+        uint32_t count = std::min(end_sector_ - next_sector_, batch_sectors_);
+
+        try
+        {
+            slot.batch = { next_sector_, count, read_function_(next_sector_, count, slot.buffer.data()) };
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            cv_.notify_all();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        next_sector_ += count;
+        ready_slots_.push_back(slot_index);
+        cv_.notify_all();
+    }
+}
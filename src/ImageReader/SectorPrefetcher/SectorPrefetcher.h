@@ -0,0 +1,68 @@
+#ifndef _SECTOR_PREFETCHER_H_
+#define _SECTOR_PREFETCHER_H_
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+/*  Reads a sector range in fixed size batches on a background thread, staying up to a set number 
+    of sectors ahead of the consumer so reading/decompressing overlaps with compressing and writing.
+    Batches are handed out in order, a depth of 0 reads each batch on the calling thread instead. */
+class SectorPrefetcher
+{
+public:
+    /*  Reads count sectors starting at start_sector, returns either out_buffer 
+        or a pointer to memory that stays valid for the lifetime of the prefetcher. */
+    using ReadFunction = std::function<const char*(uint32_t start_sector, uint32_t count, char* out_buffer)>;
+
+    struct Batch
+    {
+        uint32_t start_sector{0};
+        uint32_t count{0};
+        const char* data{nullptr};
+    };
+
+    SectorPrefetcher(const uint32_t start_sector, const uint32_t end_sector, const uint32_t batch_sectors, const size_t depth_sectors, ReadFunction read_function);
+    ~SectorPrefetcher();
+
+    SectorPrefetcher(const SectorPrefetcher&) = delete;
+    SectorPrefetcher& operator=(const SectorPrefetcher&) = delete;
+
+    /*  Waits for the next batch, returns false once the range has been read.
+        The batch is valid until the following call, read errors are rethrown here. */
+    bool next(Batch& out_batch);
+
+private:
+    struct Slot
+    {
+        std::vector<char> buffer;
+        Batch batch;
+    };
+
+    const uint32_t end_sector_;
+    const uint32_t batch_sectors_;
+    ReadFunction read_function_;
+
+    std::vector<Slot> slots_;
+    std::deque<size_t> free_slots_;
+    std::deque<size_t> ready_slots_;
+    size_t held_slot_{SIZE_MAX};
+
+    uint32_t next_sector_{0};
+    bool read_done_{false};
+    bool stop_flag_{false};
+    std::exception_ptr error_{nullptr};
+
+    std::thread read_thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    void read_worker();
+};
+
+#endif // _SECTOR_PREFETCHER_H_
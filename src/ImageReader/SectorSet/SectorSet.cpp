@@ -0,0 +1,111 @@
+#include <algorithm>
+
+#include "ImageReader/SectorSet/SectorSet.h"
+
+void SectorSet::insert(const uint32_t start_sector, const uint32_t end_sector)
+{
+    if (start_sector >= end_sector)
+    {
+        return;
+    }
+
+    // Sectors are mostly added in ascending order, so try extending the last run first
+    if (ranges_.empty() || start_sector > ranges_.back().end)
+    {
+        ranges_.push_back({ start_sector, end_sector });
+        return;
+    }
+    if (start_sector >= ranges_.back().start)
+    {
+        ranges_.back().end = std::max(ranges_.back().end, end_sector);
+        return;
+    }
+
+    // First range that touches or follows the new one, merge every range it overlaps or abuts
+    auto first = std::lower_bound(ranges_.begin(), ranges_.end(), start_sector, [](const Range& range, uint32_t sector)
+    {
+        return range.end < sector;
+    });
+
+    auto last = first;
+    Range merged = { start_sector, end_sector };
+
+    while (last != ranges_.end() && last->start <= end_sector)
+    {
+        merged.start = std::min(merged.start, last->start);
+        merged.end = std::max(merged.end, last->end);
+        ++last;
+    }
+
+    if (first == last)
+    {
+        ranges_.insert(first, merged);
+        return;
+    }
+
+    *first = merged;
+    ranges_.erase(first + 1, last);
+}
+
+void SectorSet::insert(const SectorSet& other)
+{
+    for (const Range& range : other.ranges_)
+    {
+        insert(range.start, range.end);
+    }
+}
+
+void SectorSet::clear()
+{
+    ranges_.clear();
+}
+
+std::vector<SectorSet::Range>::const_iterator SectorSet::find_range(const uint32_t sector) const
+{
+    return std::upper_bound(ranges_.begin(), ranges_.end(), sector, [](uint32_t sector, const Range& range)
+    {
+        return sector < range.end;
+    });
+}
+
+bool SectorSet::contains(const uint32_t sector) const
+{
+    auto it = find_range(sector);
+    return it != ranges_.end() && it->start <= sector;
+}
+
+bool SectorSet::contains_all(const uint32_t start_sector, const uint32_t end_sector) const
+{
+    if (start_sector >= end_sector)
+    {
+        return true;
+    }
+
+    auto it = find_range(start_sector);
+    return it != ranges_.end() && it->start <= start_sector && it->end >= end_sector;
+}
+
+uint32_t SectorSet::run_end(const uint32_t sector, const uint32_t limit) const
+{
+    auto it = find_range(sector);
+
+    if (it == ranges_.end())
+    {
+        return limit;
+    }
+    if (it->start <= sector)
+    {
+        return std::min(it->end, limit);
+    }
+    return std::min(it->start, limit);
+}
+
+uint64_t SectorSet::size() const
+{
+    uint64_t total = 0;
+    for (const Range& range : ranges_)
+    {
+        total += range.end - range.start;
+    }
+    return total;
+}
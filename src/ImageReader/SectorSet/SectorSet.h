@@ -0,0 +1,48 @@
+#ifndef _SECTOR_SET_H_
+#define _SECTOR_SET_H_
+
+#include <cstdint>
+#include <vector>
+
+/*  Set of sectors stored as sorted, non-overlapping [start, end) runs.
+    Data sectors on a disc are long file extents, so this is a few thousand runs
+    where a hash set would need an entry per sector. */
+class SectorSet
+{
+public:
+    struct Range
+    {
+        uint32_t start;
+        uint32_t end; // Exclusive
+    };
+
+    SectorSet() = default;
+
+    void insert(const uint32_t sector) { insert(sector, sector + 1); };
+    void insert(const uint32_t start_sector, const uint32_t end_sector);
+    void insert(const SectorSet& other);
+    void clear();
+
+    bool contains(const uint32_t sector) const;
+    bool contains_all(const uint32_t start_sector, const uint32_t end_sector) const;
+
+    /*  Returns the end of the run starting at sector whose sectors are all in or all out of the set,
+        capped at limit. Lets callers walk data and gap runs without per-sector lookups. */
+    uint32_t run_end(const uint32_t sector, const uint32_t limit) const;
+
+    bool empty() const { return ranges_.empty(); };
+    uint64_t size() const;
+    uint32_t max() const { return ranges_.empty() ? 0 : ranges_.back().end - 1; };
+
+    const std::vector<Range>& ranges() const { return ranges_; };
+    std::vector<Range>::const_iterator begin() const { return ranges_.begin(); };
+    std::vector<Range>::const_iterator end() const { return ranges_.end(); };
+
+private:
+    std::vector<Range> ranges_;
+
+    // First range with end > sector, ranges_.end() if none
+    std::vector<Range>::const_iterator find_range(const uint32_t sector) const;
+};
+
+#endif // _SECTOR_SET_H_
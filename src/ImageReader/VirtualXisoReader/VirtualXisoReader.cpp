@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cstring>
+
+#include "XGD.h"
+#include "AvlTree/AvlIterator.h"
+#include "ImageReader/VirtualXisoReader/VirtualXisoReader.h"
+
+VirtualXisoReader::VirtualXisoReader(const std::vector<std::filesystem::path>& in_dir_paths)
+    : in_dir_path_(in_dir_paths.front())
+{
+    if (!in_dir_path_.has_filename())
+    {
+        in_dir_path_ = in_dir_path_.parent_path();
+    }
+    if (!std::filesystem::is_directory(in_dir_path_))
+    {
+        throw XGDException(ErrCode::FILE_OPEN, HERE(), "Not a directory: " + in_dir_path_.string());
+    }
+
+    avl_tree_ = std::make_unique<AvlTree>(in_dir_path_.string(), in_dir_path_);
+    total_sectors_ = static_cast<uint32_t>(avl_tree_->out_iso_size() / Xiso::SECTOR_SIZE);
+
+    build_regions();
+}
+
+void VirtualXisoReader::build_regions()
+{
+    Xiso::Header header(static_cast<uint32_t>(avl_tree_->root()->start_sector),
+                        static_cast<uint32_t>(avl_tree_->root()->file_size),
+                        total_sectors_,
+                        Xiso::FileTime());
+
+    Region header_region;
+    header_region.end_sector = static_cast<uint32_t>(sizeof(Xiso::Header) / Xiso::SECTOR_SIZE);
+    header_region.data.resize(sizeof(Xiso::Header));
+    std::memcpy(header_region.data.data(), &header, sizeof(Xiso::Header));
+
+    regions_.push_back(std::move(header_region));
+
+    AvlIterator avl_iterator(*avl_tree_);
+    const std::vector<AvlIterator::Entry>& avl_entries = avl_iterator.entries();
+
+    for (size_t i = 0; i < avl_entries.size(); ++i)
+    {
+        Region region;
+        region.start_sector = static_cast<uint32_t>(avl_entries[i].offset / Xiso::SECTOR_SIZE);
+
+        if (avl_entries[i].directory_entry)
+        {
+            size_t processed_entries = AvlIterator::write_directory_to_buffer(avl_entries, i, region.data);
+            region.end_sector = region.start_sector + static_cast<uint32_t>(region.data.size() / Xiso::SECTOR_SIZE);
+            regions_.push_back(std::move(region));
+
+            // Empty directories still get a sector, XisoWriter fills it with padding
+            for (size_t j = i; j < i + processed_entries; ++j)
+            {
+                if (avl_entries[j].node->subdirectory == EMPTY_SUBDIRECTORY)
+                {
+                    Region empty_region;
+                    empty_region.start_sector = static_cast<uint32_t>(avl_entries[j].node->start_sector);
+                    empty_region.end_sector = empty_region.start_sector + 1;
+                    empty_region.data.resize(Xiso::SECTOR_SIZE, Xiso::PAD_BYTE);
+                    regions_.push_back(std::move(empty_region));
+                }
+            }
+
+            i += processed_entries - 1;
+        }
+        else if (avl_entries[i].node->file_size > 0)
+        {
+            region.end_sector = region.start_sector + static_cast<uint32_t>((avl_entries[i].node->file_size + Xiso::SECTOR_SIZE - 1) / Xiso::SECTOR_SIZE);
+            region.file_node = avl_entries[i].node;
+            regions_.push_back(std::move(region));
+        }
+    }
+
+    std::sort(regions_.begin(), regions_.end(), [](const Region& a, const Region& b)
+    {
+        return a.start_sector < b.start_sector;
+    });
+
+    for (size_t i = 1; i < regions_.size(); ++i)
+    {
+        if (regions_[i].start_sector < regions_[i - 1].end_sector || regions_[i].end_sector > total_sectors_)
+        {
+            throw XGDException(ErrCode::MISC, HERE(), "Virtual XISO layout has overlapping regions");
+        }
+    }
+}
+
+void VirtualXisoReader::read_sector_uncached(const uint32_t sector, char* out_buffer)
+{
+    read_bytes(static_cast<uint64_t>(sector) * Xiso::SECTOR_SIZE, Xiso::SECTOR_SIZE, out_buffer);
+}
+
+void VirtualXisoReader::read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer)
+{
+    read_bytes(static_cast<uint64_t>(start_sector) * Xiso::SECTOR_SIZE, static_cast<size_t>(count) * Xiso::SECTOR_SIZE, out_buffer);
+}
+
+void VirtualXisoReader::read_bytes(const uint64_t offset, const size_t size, char* out_buffer)
+{
+    if (offset + size > static_cast<uint64_t>(total_sectors_) * Xiso::SECTOR_SIZE)
+    {
+        throw XGDException(ErrCode::FILE_READ, HERE(), "Read past the end of virtual XISO: " + in_dir_path_.string());
+    }
+
+    uint64_t position = offset;
+    uint64_t end_position = offset + size;
+
+    // First region that ends after position
+    auto region = std::upper_bound(regions_.begin(), regions_.end(), static_cast<uint32_t>(position / Xiso::SECTOR_SIZE),
+        [](uint32_t sector, const Region& region)
+        {
+            return sector < region.end_sector;
+        });
+
+    while (position < end_position)
+    {
+        uint64_t region_start = (region != regions_.end()) ? static_cast<uint64_t>(region->start_sector) * Xiso::SECTOR_SIZE : end_position;
+        uint64_t region_end = (region != regions_.end()) ? static_cast<uint64_t>(region->end_sector) * Xiso::SECTOR_SIZE : end_position;
+
+        if (position < region_start)
+        {
+            // Gaps between directory tables and files are padded, before the first table and after the last sector of data they're zeroed
+            bool is_padding = region != regions_.end() && region != regions_.begin() + 1;
+            uint64_t gap_size = std::min(region_start, end_position) - position;
+
+            std::memset(out_buffer + (position - offset), is_padding ? Xiso::PAD_BYTE : 0x00, gap_size);
+            position += gap_size;
+            continue;
+        }
+
+        uint64_t read_size = std::min(region_end, end_position) - position;
+        read_region(*region, position - region_start, read_size, out_buffer + (position - offset));
+
+        position += read_size;
+        ++region;
+    }
+}
+
+void VirtualXisoReader::read_region(const Region& region, const uint64_t offset, const size_t size, char* out_buffer)
+{
+    if (!region.file_node)
+    {
+        std::memcpy(out_buffer, region.data.data() + offset, size);
+        return;
+    }
+
+    const AvlTree::Node& node = *region.file_node;
+    size_t file_bytes = (offset < node.file_size) ? static_cast<size_t>(std::min(static_cast<uint64_t>(size), node.file_size - offset)) : 0;
+
+    if (file_bytes > 0)
+    {
+        std::shared_ptr<split::pread_file> source_file = open_source_file(node);
+
+        if (source_file->read(offset, out_buffer, file_bytes) != file_bytes)
+        {
+            throw XGDException(ErrCode::FILE_READ, HERE(), "Failed to read file data, file may have changed: " + node.path.string());
+        }
+    }
+
+    // Last sector of a file is padded
+    std::memset(out_buffer + file_bytes, Xiso::PAD_BYTE, size - file_bytes);
+}
+
+std::shared_ptr<split::pread_file> VirtualXisoReader::open_source_file(const AvlTree::Node& node)
+{
+    std::lock_guard<std::mutex> lock(source_mutex_);
+
+    if (source_node_ != &node)
+    {
+        std::shared_ptr<split::pread_file> source_file = std::make_shared<split::pread_file>(std::vector<std::filesystem::path>{ node.path });
+        if (!source_file->is_open())
+        {
+            throw XGDException(ErrCode::FILE_OPEN, HERE(), node.path.string());
+        }
+
+        source_file_ = source_file;
+        source_node_ = &node;
+    }
+
+    return source_file_;
+}
@@ -0,0 +1,62 @@
+#ifndef _VIRTUAL_XISO_READER_H_
+#define _VIRTUAL_XISO_READER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+#include "SplitFStream/SplitFStream.h"
+
+#include "Formats/Xiso.h"
+#include "AvlTree/AvlTree.h"
+#include "ImageReader/ImageReader.h"
+
+/*  Presents a directory as the XISO that XisoWriter would build from it, without writing anything.
+    The AvlTree layout is computed up front, the header, directory tables and padding are synthesized
+    and file data is read from the source files as sectors are requested.
+    For the constructor, provide the directory's path as the only element. */
+class VirtualXisoReader : public ImageReader
+{
+public:
+    VirtualXisoReader(const std::vector<std::filesystem::path>& in_dir_paths);
+    ~VirtualXisoReader() override = default;
+
+    void read_bytes(const uint64_t offset, const size_t size, char* out_buffer) override;
+    void read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer) override;
+
+    uint64_t image_offset() override { return 0; };
+    uint32_t total_sectors() override { return total_sectors_; };
+
+    std::string name() override { return in_dir_path_.filename().string(); };
+
+protected:
+    void read_sector_uncached(const uint32_t sector, char* out_buffer) override;
+
+private:
+    // A run of sectors with content, anything between regions is padding
+    struct Region
+    {
+        uint32_t start_sector{0};
+        uint32_t end_sector{0};
+        const AvlTree::Node* file_node{nullptr}; // Data is read from this file if set
+        std::vector<char> data; // Otherwise the region's synthesized sectors
+    };
+
+    std::filesystem::path in_dir_path_;
+    std::unique_ptr<AvlTree> avl_tree_{nullptr};
+    std::vector<Region> regions_; // Sorted by start sector, regions_.front() is the header
+    uint32_t total_sectors_{0};
+
+    // Most recently opened source file, reads of one file usually come in a row
+    std::mutex source_mutex_;
+    const AvlTree::Node* source_node_{nullptr};
+    std::shared_ptr<split::pread_file> source_file_{nullptr};
+
+    void build_regions();
+    void read_region(const Region& region, const uint64_t offset, const size_t size, char* out_buffer);
+    std::shared_ptr<split::pread_file> open_source_file(const AvlTree::Node& node);
+};
+
+#endif // _VIRTUAL_XISO_READER_H_
@@ -8,35 +8,52 @@
 XisoReader::XisoReader(const std::vector<std::filesystem::path>& in_xiso_paths) 
     : in_xiso_paths_(in_xiso_paths) 
 {
-    in_file_ = split::ifstream(in_xiso_paths_);
-    if (!in_file_.is_open()) 
+    // Mapped pages can't be dropped from the cache behind the reader, streaming mode uses positional reads
+    if (!split::streaming_mode())
     {
-        throw XGDException(ErrCode::FILE_OPEN, HERE(), in_xiso_paths_.front().string() + ((in_xiso_paths_.size() > 1) ? (" and " + in_xiso_paths_.back().string()) : ""));
+        try 
+        {
+            mapped_file_ = split::mapped_file(in_xiso_paths_);
+        } 
+        catch (const std::exception& e) 
+        {
+            XGDLog(Debug) << "Memory mapping unavailable, falling back to positional reads: " << e.what() << XGDLog::Endl;
+        }
+    }
+
+    if (mapped_file_.is_open()) 
+    {
+        total_sectors_ = static_cast<uint32_t>(mapped_file_.size() / Xiso::SECTOR_SIZE);
+    } 
+    else 
+    {
+        in_file_ = split::pread_file(in_xiso_paths_);
+        if (!in_file_.is_open()) 
+        {
+            throw XGDException(ErrCode::FILE_OPEN, HERE(), in_xiso_paths_.front().string() + ((in_xiso_paths_.size() > 1) ? (" and " + in_xiso_paths_.back().string()) : ""));
+        }
+
+        total_sectors_ = static_cast<uint32_t>(in_file_.size() / Xiso::SECTOR_SIZE);
     }
 
-    in_file_.seekg(0, std::ios::end);
-    total_sectors_ = static_cast<uint32_t>(in_file_.tellg() / Xiso::SECTOR_SIZE);
     image_offset_ = get_image_offset(); 
 }
 
 XisoReader::~XisoReader() 
 {
-    if (in_file_.is_open()) 
-    {
-        in_file_.close();
-    }
+    in_file_.close();
+    mapped_file_.close();
 }
 
-void XisoReader::read_sector(const uint32_t sector, char* out_buffer) 
+void XisoReader::read_sector_uncached(const uint32_t sector, char* out_buffer) 
 {
     uint64_t position = static_cast<uint64_t>(sector) * static_cast<uint64_t>(Xiso::SECTOR_SIZE);
-    in_file_.seekg(position, std::ios::beg);
-    in_file_.read(out_buffer, Xiso::SECTOR_SIZE);
+    uint64_t bytes_read = read_raw(position, Xiso::SECTOR_SIZE, out_buffer);
 
-    if (in_file_.fail() || in_file_.gcount() != Xiso::SECTOR_SIZE) 
+    if (bytes_read != Xiso::SECTOR_SIZE) 
     {
         std::cerr << "Failed to read sector: " << sector 
-                  << ", Bytes read: " << in_file_.gcount() 
+                  << ", Bytes read: " << bytes_read 
                   << ", Expected bytes: " << Xiso::SECTOR_SIZE << std::endl;
 
         throw XGDException(ErrCode::FILE_READ, HERE(), "Failed to read sector from input file");
@@ -45,16 +62,30 @@ void XisoReader::read_sector(const uint32_t sector, char* out_buffer)
 
 void XisoReader::read_bytes(const uint64_t offset, const size_t size, char* out_buffer) 
 {
-    in_file_.seekg(offset, std::ios::beg);
-    if (in_file_.fail() || in_file_.tellg() != offset) 
+    if (read_raw(offset, size, out_buffer) != size) 
     {
-        throw XGDException(ErrCode::FILE_SEEK, HERE(), "Failed to seek to offset in input file");
+        throw XGDException(ErrCode::FILE_READ, HERE(), "Failed to read bytes from input file");
     }
-    in_file_.read(out_buffer, size);
-    if (in_file_.fail() || in_file_.gcount() != size) 
+}
+
+void XisoReader::read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer) 
+{
+    read_bytes(static_cast<uint64_t>(start_sector) * Xiso::SECTOR_SIZE, static_cast<size_t>(count) * Xiso::SECTOR_SIZE, out_buffer);
+}
+
+XisoReader::Span XisoReader::span_bytes(const uint64_t offset, const size_t size) 
+{
+    const char* data = mapped_file_.data(offset, size);
+    return data ? Span{ data, size } : Span();
+}
+
+uint64_t XisoReader::read_raw(const uint64_t offset, const size_t size, char* out_buffer) 
+{
+    if (mapped_file_.is_open()) 
     {
-        throw XGDException(ErrCode::FILE_READ, HERE(), "Failed to read bytes from input file");
+        return mapped_file_.read(offset, out_buffer, size);
     }
+    return in_file_.read(offset, out_buffer, size);
 }
 
 uint64_t XisoReader::get_image_offset() 
@@ -71,10 +102,7 @@ uint64_t XisoReader::get_image_offset()
 
     for (int offset : seek_offsets) 
     {
-        in_file_.seekg(Xiso::MAGIC_OFFSET + offset, std::ios::beg);
-        in_file_.read(buffer, Xiso::MAGIC_DATA_LEN);
-
-        if (in_file_.fail()) 
+        if (read_raw(Xiso::MAGIC_OFFSET + offset, Xiso::MAGIC_DATA_LEN, buffer) != Xiso::MAGIC_DATA_LEN) 
         {
             throw XGDException(ErrCode::FILE_READ, HERE(), "Failed to read magic data from input file");
         }
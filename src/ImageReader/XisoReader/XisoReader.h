@@ -17,22 +17,28 @@ public:
     XisoReader(const std::vector<std::filesystem::path>& in_xiso_paths);
     ~XisoReader() override;
 
-    void read_sector(const uint32_t sector, char* out_buffer) override;
     void read_bytes(const uint64_t offset, const size_t size, char* out_buffer) override;
+    void read_sectors(const uint32_t start_sector, const uint32_t count, char* out_buffer) override;
+    Span span_bytes(const uint64_t offset, const size_t size) override;
 
     uint64_t image_offset() override { return image_offset_; };
     uint32_t total_sectors() override { return total_sectors_; };
 
     std::string name() override { return in_xiso_paths_.front().stem().string(); };
 
+protected:
+    void read_sector_uncached(const uint32_t sector, char* out_buffer) override;
+
 private:
     std::vector<std::filesystem::path> in_xiso_paths_;
-    split::ifstream in_file_;
+    split::mapped_file mapped_file_;
+    split::pread_file in_file_;
 
     uint64_t image_offset_{0};
     uint32_t total_sectors_{0};
 
     uint64_t get_image_offset();
+    uint64_t read_raw(const uint64_t offset, const size_t size, char* out_buffer);
 };
 
 #endif // _XISO_READER_H_
\ No newline at end of file
@@ -1,47 +1,38 @@
 #include <functional>
 #include <cstring>
 
+#include <lz4.h>
 #include <lz4hc.h>
 
 #include "ImageWriter/CCIWriter/CCIWriter.h"
 #include "AvlTree/AvlIterator.h"
 
-CCIWriter::CCIWriter(std::shared_ptr<ImageReader> image_reader, const ScrubType scrub_type)
-    :   image_reader_(image_reader), 
-        scrub_type_(scrub_type)
+namespace
 {
-    init_cci_writer();
-}
+    // Compression states belong to the pool threads and are reused by every CCIWriter
+    struct LZ4State
+    {
+        std::vector<char> fast_state;
+        std::vector<char> hc_state;
 
-CCIWriter::CCIWriter(const std::filesystem::path& in_dir_path)
-    : in_dir_path_(in_dir_path)
-{
-    init_cci_writer();
+        LZ4State()
+            :   fast_state(LZ4_sizeofState()), 
+                hc_state(LZ4_sizeofStateHC()) {}
+    };
 }
 
-CCIWriter::~CCIWriter()
-{
-    {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        stop_flag_ = true;
-    }
-    cv_.notify_all();
-    for (std::thread& thread : thread_pool_)
-    {
-        if (thread.joinable())
-        {
-            thread.join();
-        }
-    }
-}
+CCIWriter::CCIWriter(std::shared_ptr<ImageReader> image_reader, const ScrubType scrub_type, const CompressionPreset compression_preset, const int compression_level)
+    :   image_reader_(image_reader), 
+        scrub_type_(scrub_type),
+        compress_level_(compression_preset, compression_level) {}
 
-void CCIWriter::init_cci_writer()
-{
-    for (uint32_t i = 0; i < std::min(std::thread::hardware_concurrency(), static_cast<uint32_t>(32)); ++i)
-    {
-        thread_pool_.emplace_back(&CCIWriter::thread_worker, this);
-    }
-}
+CCIWriter::CCIWriter(const std::filesystem::path& in_dir_path, const CompressionPreset compression_preset, const int compression_level)
+    :   in_dir_path_(in_dir_path),
+        compress_level_(compression_preset, compression_level) {}
+
+CCIWriter::CCIWriter(std::shared_ptr<ZARReader> zar_reader, const CompressionPreset compression_preset, const int compression_level)
+    :   ImageWriter(zar_reader),
+        compress_level_(compression_preset, compression_level) {}
 
 std::vector<std::filesystem::path> CCIWriter::convert(const std::filesystem::path& out_cci_path) 
 {
@@ -64,10 +55,19 @@ std::vector<std::filesystem::path> CCIWriter::convert(const std::filesystem::pat
         AvlTree avl_tree(in_dir_path_.filename().string(), in_dir_path_);
         convert_to_cci_from_avl(avl_tree);
     }
+    else if (zar_reader_)
+    {
+        AvlTree avl_tree(zar_reader_->name(), *zar_reader_);
+        convert_to_cci_from_avl(avl_tree);
+    }
     else if (!image_reader_) 
     {
         throw XGDException(ErrCode::ISO_INVALID, HERE(), "No input data");
     }
+    else if (scrub_type_ == ScrubType::NONE && compress_level_.is_default() && image_reader_->lz4_block_format() == FileType::CSO)
+    {
+        transcode_to_cci();
+    }
     else
     {
         convert_to_cci(scrub_type_ == ScrubType::PARTIAL);
@@ -81,67 +81,135 @@ void CCIWriter::convert_to_cci(const bool scrub)
     ImageReader& image_reader = *image_reader_;
     uint32_t end_sector = image_reader.total_sectors();
     uint32_t sector_offset = static_cast<uint32_t>(image_reader.image_offset() / Xiso::SECTOR_SIZE);
-    const std::unordered_set<uint32_t>* data_sectors;
+    const SectorSet* data_sectors = nullptr;
 
     if (scrub) 
     {
-        data_sectors = &image_reader.data_sectors();
         end_sector = std::min(end_sector, image_reader.max_data_sector() + 1);
+
+        if (image_reader.platform() == Platform::OGX) 
+        {
+            data_sectors = &image_reader.data_sectors();
+        }
     }
 
     prog_total_ = end_sector - sector_offset - 1;
     prog_processed_ = 0;
 
-    std::ofstream out_file(out_filepath_1_, std::ios::binary);
+    split::async_ofstream out_file(out_filepath_1_, std::ios::binary);
     if (!out_file.is_open()) 
     {
         throw std::runtime_error("Failed to open output file: " + out_filepath_1_.string());
     }
 
-    XGDLog() << "Writing CCI file" << XGDLog::Endl;
+    out_cache_.open(out_filepath_1_);
 
-    uint32_t current_sector = sector_offset;
-    uint32_t num_threads = static_cast<uint32_t>(thread_pool_.size());
+    XGDLog() << "Writing CCI file" << XGDLog::Endl;
 
-    std::vector<char> read_buffer(Xiso::SECTOR_SIZE * num_threads);
-    
     std::vector<CCI::IndexInfo> index_infos;
     index_infos.reserve((end_sector - sector_offset) + 1);
 
-    while (current_sector < end_sector) 
+    std::unique_ptr<CompressPipeline> pipeline = create_pipeline(out_file, index_infos);
+
+    uint32_t batch_sectors = static_cast<uint32_t>(XGD::BULK_BUFFER_SIZE / Xiso::SECTOR_SIZE);
+
+    std::unique_ptr<SectorPrefetcher> prefetcher = prefetch_sectors_scrubbed(image_reader, sector_offset, end_sector, batch_sectors, data_sectors);
+    SectorPrefetcher::Batch batch;
+
+    while (prefetcher->next(batch)) 
     {
-        uint32_t read_sectors = std::min(end_sector - current_sector, num_threads);
+        pipeline->submit(batch.data, batch.count);
 
-        for (uint32_t i = 0; i < read_sectors; ++i)
-        {
-            bool write_sector = true;
+        XGDLog().print_progress(prog_processed_ += batch.count, prog_total_);
 
-            if (scrub && image_reader.platform() == Platform::OGX) 
-            {
-                write_sector = data_sectors->find(current_sector) != data_sectors->end();
-            }
+        check_status_flags();
+    }
 
-            if (write_sector) 
-            {
-                image_reader.read_sector(current_sector, read_buffer.data() + (i * Xiso::SECTOR_SIZE));
-            } 
-            else 
-            {
-                std::memset(read_buffer.data() + (i * Xiso::SECTOR_SIZE), 0x00, Xiso::SECTOR_SIZE);
-            }
+    pipeline->flush();
+
+    finalize_out_file(out_file, index_infos);
+    out_file.close();
+    out_cache_.close();
+}
+
+/*  CSO and CCI images are both made of single LZ4 blocks, so each block is copied as is 
+    with only its framing rewritten. Everything happens on this thread, it's bound by I/O. */
+void CCIWriter::transcode_to_cci()
+{
+    ImageReader& image_reader = *image_reader_;
+    uint32_t total_sectors = image_reader.total_sectors();
+
+    prog_total_ = total_sectors - 1;
+    prog_processed_ = 0;
 
-            current_sector++;
+    split::async_ofstream out_file(out_filepath_1_, std::ios::binary);
+    if (!out_file.is_open()) 
+    {
+        throw std::runtime_error("Failed to open output file: " + out_filepath_1_.string());
+    }
+
+    out_cache_.open(out_filepath_1_);
+    out_position_ = static_cast<uint64_t>(out_file.tellp());
+
+    XGDLog() << "Writing CCI file" << XGDLog::Endl;
+
+    std::vector<CCI::IndexInfo> index_infos;
+    index_infos.reserve(total_sectors + 1);
+
+    const uint32_t batch_sectors = static_cast<uint32_t>(XGD::BULK_BUFFER_SIZE / Xiso::SECTOR_SIZE);
+    const size_t out_stride = Xiso::SECTOR_SIZE + LZ4_compressBound(Xiso::SECTOR_SIZE);
+
+    std::vector<char> in_buffer;
+    std::vector<ImageReader::LZ4Block> blocks;
+    std::vector<char> out_buffer(batch_sectors * out_stride);
+    std::vector<CompressPipeline::Sector> sectors(batch_sectors);
+
+    for (uint32_t sector = 0; sector < total_sectors; sector += batch_sectors)
+    {
+        uint32_t count = std::min(batch_sectors, total_sectors - sector);
+
+        image_reader.read_lz4_blocks(sector, count, in_buffer, blocks);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            sectors[i] = transcode_block(in_buffer.data(), blocks[i], out_buffer.data() + (i * out_stride));
         }
 
-        compress_and_write_sectors_managed(out_file, index_infos, read_sectors, read_buffer.data());
+        write_sectors(out_file, index_infos, sectors.data(), count);
 
-        XGDLog().print_progress(prog_processed_ += read_sectors, prog_total_);
+        XGDLog().print_progress(prog_processed_ += count, prog_total_);
 
         check_status_flags();
     }
 
     finalize_out_file(out_file, index_infos);
     out_file.close();
+    out_cache_.close();
+}
+
+/*  out_buffer has room for a sector followed by a compressed one, for blocks that are too large 
+    to be stored compressed here and have to be decompressed and run through compress_sector. */
+CompressPipeline::Sector CCIWriter::transcode_block(const char* in_block, const ImageReader::LZ4Block& block, char* out_buffer)
+{
+    const char* block_data = in_block + block.offset;
+
+    if (!block.compressed)
+    {
+        return { block_data, Xiso::SECTOR_SIZE, false };
+    }
+
+    // Same limit as compress_sector
+    if (block.size < Xiso::SECTOR_SIZE - (4 + ALIGN_MULT))
+    {
+        return { block_data, block.size, true };
+    }
+
+    if (LZ4_decompress_safe(block_data, out_buffer, static_cast<int>(block.size), Xiso::SECTOR_SIZE) != Xiso::SECTOR_SIZE)
+    {
+        throw XGDException(ErrCode::MISC, HERE(), "LZ4_decompress_safe failed");
+    }
+
+    return compress_sector(out_buffer, out_buffer + Xiso::SECTOR_SIZE);
 }
 
 void CCIWriter::convert_to_cci_from_avl(AvlTree& avl_tree) 
@@ -152,22 +220,26 @@ void CCIWriter::convert_to_cci_from_avl(AvlTree& avl_tree)
     AvlIterator avl_iterator(avl_tree);
     std::vector<AvlIterator::Entry> avl_entries = avl_iterator.entries();
 
-    std::ofstream out_file(out_filepath_1_, std::ios::binary);
+    split::async_ofstream out_file(out_filepath_1_, std::ios::binary);
     if (!out_file.is_open()) 
     {
         throw std::runtime_error("Failed to open output file: " + out_filepath_1_.string());
     }
 
+    out_cache_.open(out_filepath_1_);
+
     XGDLog() << "Writing CCI file" << XGDLog::Endl;
 
     uint32_t sectors_to_write = num_sectors(avl_tree.out_iso_size());
     std::vector<CCI::IndexInfo> index_infos;
     index_infos.reserve(sectors_to_write + 1);
 
-    write_iso_header(out_file, index_infos, avl_tree);
+    std::unique_ptr<CompressPipeline> pipeline = create_pipeline(out_file, index_infos);
+
+    write_iso_header(*pipeline, avl_tree);
 
     uint32_t pad_sectors = num_sectors(avl_entries.front().offset - sizeof(Xiso::Header));
-    write_padding_sectors(out_file, index_infos, pad_sectors, 0x00);
+    write_padding_sectors(*pipeline, pad_sectors, 0x00);
 
     uint32_t sectors_written = num_sectors(avl_entries.front().offset);
 
@@ -179,7 +251,7 @@ void CCIWriter::convert_to_cci_from_avl(AvlTree& avl_tree)
 
             XGDLog(Debug) << "Padding " << pad_sectors << " sectors\n";
 
-            write_padding_sectors(out_file, index_infos, pad_sectors, Xiso::PAD_BYTE);
+            write_padding_sectors(*pipeline, pad_sectors, Xiso::PAD_BYTE);
             sectors_written += pad_sectors;
         } 
 
@@ -195,18 +267,18 @@ void CCIWriter::convert_to_cci_from_avl(AvlTree& avl_tree)
             i += entries_processed - 1;
 
             uint32_t write_sectors = num_sectors(dir_buffer.size());
-            compress_and_write_sectors_managed(out_file, index_infos, write_sectors, dir_buffer.data());
+            pipeline->submit(dir_buffer.data(), write_sectors);
             sectors_written += write_sectors;
         } 
         else 
         {
             if (image_reader_) 
             {
-                write_file_from_reader(out_file, index_infos, *avl_entries[i].node);
+                write_file_from_reader(*pipeline, *avl_entries[i].node);
             } 
             else 
             {
-                write_file_from_dir(out_file, index_infos, *avl_entries[i].node);
+                write_file_from_dir(*pipeline, *avl_entries[i].node);
             }
 
             sectors_written += num_sectors(avl_entries[i].node->file_size);
@@ -217,14 +289,17 @@ void CCIWriter::convert_to_cci_from_avl(AvlTree& avl_tree)
 
     if (pad_sectors > 0) 
     {
-        write_padding_sectors(out_file, index_infos, pad_sectors, 0x00);
+        write_padding_sectors(*pipeline, pad_sectors, 0x00);
     }
 
+    pipeline->flush();
+
     finalize_out_file(out_file, index_infos);
     out_file.close();
+    out_cache_.close();
 }
 
-void CCIWriter::write_iso_header(std::ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos, AvlTree& avl_tree)
+void CCIWriter::write_iso_header(CompressPipeline& pipeline, AvlTree& avl_tree)
 {
     Xiso::Header xiso_header(   static_cast<uint32_t>(avl_tree.root()->start_sector), 
                                 static_cast<uint32_t>(avl_tree.root()->file_size), 
@@ -233,21 +308,28 @@ void CCIWriter::write_iso_header(std::ofstream& out_file, std::vector<CCI::Index
 
     static_assert(!(sizeof(Xiso::Header) % Xiso::SECTOR_SIZE), "Xiso::Header size must be a multiple of Xiso::SECTOR_SIZE");
 
-    compress_and_write_sectors_managed(out_file, index_infos, num_sectors(sizeof(Xiso::Header)), reinterpret_cast<char*>(&xiso_header));
+    pipeline.submit(reinterpret_cast<char*>(&xiso_header), num_sectors(sizeof(Xiso::Header)));
 }
 
-void CCIWriter::write_padding_sectors(std::ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos, const uint32_t num_sectors, const char pad_byte)
+void CCIWriter::write_padding_sectors(CompressPipeline& pipeline, const uint32_t num_sectors, const char pad_byte)
 {
-    std::vector<char> pad_sector(Xiso::SECTOR_SIZE * num_sectors, pad_byte);
-    compress_and_write_sectors_managed(out_file, index_infos, num_sectors, pad_sector.data());
+    const uint32_t buffer_sectors = static_cast<uint32_t>(XGD::BULK_BUFFER_SIZE / Xiso::SECTOR_SIZE);
+    std::vector<char> pad_sector(static_cast<size_t>(std::min(num_sectors, buffer_sectors)) * Xiso::SECTOR_SIZE, pad_byte);
+
+    for (uint32_t sectors_remaining = num_sectors; sectors_remaining > 0; )
+    {
+        uint32_t count = std::min(sectors_remaining, buffer_sectors);
+        pipeline.submit(pad_sector.data(), count);
+        sectors_remaining -= count;
+    }
 }
 
-void CCIWriter::write_file_from_reader(std::ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos, AvlTree::Node& node) 
+void CCIWriter::write_file_from_reader(CompressPipeline& pipeline, AvlTree::Node& node) 
 {
     ImageReader& image_reader = *image_reader_;
     uint64_t bytes_remaining = node.file_size;
     uint64_t read_position = image_reader.image_offset() + (node.old_start_sector * Xiso::SECTOR_SIZE);
-    std::vector<char> read_buffer(Xiso::SECTOR_SIZE * thread_pool_.size());
+    std::vector<char> read_buffer(XGD::BULK_BUFFER_SIZE);
 
     while (bytes_remaining > 0) 
     {
@@ -260,7 +342,7 @@ void CCIWriter::write_file_from_reader(std::ofstream& out_file, std::vector<CCI:
             std::memset(read_buffer.data() + read_size, Xiso::PAD_BYTE, (Xiso::SECTOR_SIZE - (read_size % Xiso::SECTOR_SIZE)));
         }
 
-        compress_and_write_sectors_managed(out_file, index_infos, num_sectors(read_size), read_buffer.data());
+        pipeline.submit(read_buffer.data(), num_sectors(read_size));
 
         bytes_remaining -= read_size;
         read_position += read_size;
@@ -271,23 +353,19 @@ void CCIWriter::write_file_from_reader(std::ofstream& out_file, std::vector<CCI:
     }
 }
 
-void CCIWriter::write_file_from_dir(std::ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos, AvlTree::Node& node) 
+void CCIWriter::write_file_from_dir(CompressPipeline& pipeline, AvlTree::Node& node) 
 {
-    std::ifstream in_file(node.path, std::ios::binary);
-    if (!in_file.is_open()) 
-    {
-        throw std::runtime_error("Failed to open input file: " + node.path.string());
-    }
+    std::unique_ptr<std::istream> in_file = open_tree_file(node);
 
     uint64_t bytes_remaining = node.file_size;
-    std::vector<char> read_buffer(Xiso::SECTOR_SIZE * thread_pool_.size());
+    std::vector<char> read_buffer(XGD::BULK_BUFFER_SIZE);
 
     while (bytes_remaining > 0) 
     {
         uint64_t read_size = std::min(bytes_remaining, read_buffer.size());
 
-        in_file.read(read_buffer.data(), read_size);
-        if (in_file.fail()) 
+        in_file->read(read_buffer.data(), read_size);
+        if (in_file->fail()) 
         {
             throw std::runtime_error("Failed to read from input file: " + node.path.string());
         }
@@ -297,7 +375,7 @@ void CCIWriter::write_file_from_dir(std::ofstream& out_file, std::vector<CCI::In
             std::memset(read_buffer.data() + read_size, Xiso::PAD_BYTE, (Xiso::SECTOR_SIZE - (read_size % Xiso::SECTOR_SIZE)));
         }
 
-        compress_and_write_sectors_managed(out_file, index_infos, num_sectors(read_size), read_buffer.data());
+        pipeline.submit(read_buffer.data(), num_sectors(read_size));
 
         bytes_remaining -= read_size;
 
@@ -305,89 +383,51 @@ void CCIWriter::write_file_from_dir(std::ofstream& out_file, std::vector<CCI::In
 
         check_status_flags();
     }
-
-    in_file.close();
 }
 
-void CCIWriter::thread_worker()
+std::unique_ptr<CompressPipeline> CCIWriter::create_pipeline(split::async_ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos)
 {
-    while (true)
-    {
-        CompressTask task;
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            cv_.wait(lock, [this] { return stop_flag_ || !task_queue_.empty(); });
-
-            if (stop_flag_ && task_queue_.empty())
-            {
-                return;
-            }
+    out_position_ = static_cast<uint64_t>(out_file.tellp());
+
+    return std::make_unique<CompressPipeline>(LZ4_compressBound(Xiso::SECTOR_SIZE), 
+        [this](const char* in_sector, char* out_buffer) {
+            return compress_sector(in_sector, out_buffer);
+        }, 
+        [this, &out_file, &index_infos](const CompressPipeline::Sector* sectors, size_t count) {
+            write_sectors(out_file, index_infos, sectors, count);
+        },
+        &compress_level_);
+}
 
-            task = std::move(task_queue_.front());
-            task_queue_.pop();
-        }
+CompressPipeline::Sector CCIWriter::compress_sector(const char* in_sector, char* out_buffer)
+{
+    thread_local LZ4State lz4_state;
 
-        int compressed_size = LZ4_compress_HC(task.in_buffer, task.out_buffer, task.in_size, task.in_size, 12);
+    int level = compress_level_.level(in_sector);
+    int compressed_size = (level == CompressLevel::FAST_LEVEL)
+        ? LZ4_compress_fast_extState(lz4_state.fast_state.data(), in_sector, out_buffer, Xiso::SECTOR_SIZE, Xiso::SECTOR_SIZE, 1)
+        : LZ4_compress_HC_extStateHC(lz4_state.hc_state.data(), in_sector, out_buffer, Xiso::SECTOR_SIZE, Xiso::SECTOR_SIZE, level);
 
-        CompressedTaskResult result; 
-        result.sector_idx       = task.sector_idx; 
-        result.compressed_size  = compressed_size;
-        result.compressed       = compressed_size > 0 && compressed_size < static_cast<int>(Xiso::SECTOR_SIZE - (4 + ALIGN_MULT));
-        result.buffer_to_write  = result.compressed ? task.out_buffer : task.in_buffer; 
-        
-        task.promise.set_value(result);
+    if (compressed_size > 0 && compressed_size < static_cast<int>(Xiso::SECTOR_SIZE - (4 + ALIGN_MULT)))
+    {
+        return { out_buffer, static_cast<uint32_t>(compressed_size), true };
     }
+    return { in_sector, Xiso::SECTOR_SIZE, false };
 }
 
 /*  This will check if the out file needs to be split or if it needs room 
     for a CCI header using check_and_manage_write and finalize_out_file */
-void CCIWriter::compress_and_write_sectors_managed(std::ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos, const uint32_t num_sectors, const char* in_buffer)
+void CCIWriter::write_sectors(split::async_ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos, const CompressPipeline::Sector* sectors, size_t count)
 {
-    std::vector<std::future<CompressedTaskResult>> futures;
-    std::vector<std::vector<char>> compress_buffers(num_sectors, std::vector<char>(LZ4_compressBound(Xiso::SECTOR_SIZE)));
-
-    for (uint32_t i = 0; i < num_sectors; ++i)
-    {
-        std::promise<CompressedTaskResult> promise;
-        futures.emplace_back(promise.get_future());
-
-        CompressTask task;
-        task.in_buffer = in_buffer + (i * Xiso::SECTOR_SIZE);
-        task.in_size = Xiso::SECTOR_SIZE;
-        task.out_buffer = compress_buffers[i].data();
-        task.sector_idx = i;
-        task.promise = std::move(promise);
-
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            task_queue_.push(std::move(task));
-        }
-        cv_.notify_one();
-    }
-
-    std::vector<CompressedTaskResult> ordered_results;
-    ordered_results.reserve(num_sectors);
-
-    for (auto& future : futures)
-    {
-        ordered_results.push_back(future.get());
-    }
-
-    // Order results by sector index incase they were compressed out of order
-    std::sort(ordered_results.begin(), ordered_results.end(), [](const CompressedTaskResult& a, const CompressedTaskResult& b) 
-    {
-        return a.sector_idx < b.sector_idx;
-    });
-
-    for (const auto& result : ordered_results)
+    for (size_t i = 0; i < count; ++i)
     {
         check_and_manage_write(out_file, index_infos);
 
-        if (result.compressed)
+        if (sectors[i].compressed)
         {
-            uint8_t padding = static_cast<uint8_t>(((result.compressed_size + 1 + ALIGN_MULT - 1) / ALIGN_MULT * ALIGN_MULT) - (result.compressed_size + 1));
+            uint8_t padding = static_cast<uint8_t>(((sectors[i].size + 1 + ALIGN_MULT - 1) / ALIGN_MULT * ALIGN_MULT) - (sectors[i].size + 1));
             out_file.write(reinterpret_cast<const char*>(&padding), sizeof(uint8_t));
-            out_file.write(result.buffer_to_write, result.compressed_size);
+            out_file.write(sectors[i].data, sectors[i].size);
 
             if (padding != 0)
             {
@@ -395,44 +435,52 @@ void CCIWriter::compress_and_write_sectors_managed(std::ofstream& out_file, std:
                 out_file.write(empty_buffer.data(), padding);
             }
 
-            index_infos.push_back({ static_cast<uint32_t>(result.compressed_size + 1 + padding), true });
+            index_infos.push_back({ static_cast<uint32_t>(sectors[i].size + 1 + padding), true });
+            out_position_ += sectors[i].size + 1 + padding;
         }
         else
         {
-            out_file.write(result.buffer_to_write, Xiso::SECTOR_SIZE);
+            out_file.write(sectors[i].data, Xiso::SECTOR_SIZE);
             index_infos.push_back({ Xiso::SECTOR_SIZE, false });
+            out_position_ += Xiso::SECTOR_SIZE;
         }
 
         if (out_file.fail())
         {
-            throw std::runtime_error("Failed to write to output file");
+            throw XGDException(ErrCode::FILE_WRITE, HERE(), "Failed to write to output file");
         }
     }
+
+    out_cache_.trim(out_position_);
 }
 
-void CCIWriter::check_and_manage_write(std::ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos)
+void CCIWriter::check_and_manage_write(split::async_ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos)
 {
-    if (static_cast<uint64_t>(out_file.tellp()) > CCI::SPLIT_OFFSET)
+    if (out_position_ > CCI::SPLIT_OFFSET)
     {
         finalize_out_file(out_file, index_infos);
         out_file.close();
 
-        out_file = std::ofstream(out_filepath_2_, std::ios::binary);
+        out_file = split::async_ofstream(out_filepath_2_, std::ios::binary);
         if (!out_file.is_open())
         {
             throw XGDException(ErrCode::FILE_OPEN, HERE(), "Failed to open output file: " + out_filepath_2_.string());
         }
+
+        out_cache_.open(out_filepath_2_);
+        out_position_ = 0;
     }
 
-    if (index_infos.size() == 0 && out_file.tellp() == 0)
+    if (index_infos.size() == 0 && out_position_ == 0)
     {
         std::vector<char> empty_buffer(sizeof(CCI::Header), 0);
         out_file.write(empty_buffer.data(), sizeof(CCI::Header));
+        out_position_ += sizeof(CCI::Header);
     }
 }
 
 //  This writes the index info and finalized header to the current out file
-void CCIWriter::finalize_out_file(std::ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos) 
+void CCIWriter::finalize_out_file(split::async_ofstream& out_file, std::vector<CCI::IndexInfo>& index_infos) 
 {
     out_file.seekp(0, std::ios::end);
 
@@ -455,6 +503,8 @@ void CCIWriter::finalize_out_file(std::ofstream& out_file, std::vector<CCI::Inde
     out_file.seekp(0, std::ios::beg);
     out_file.write(reinterpret_cast<char*>(&cci_header), sizeof(CCI::Header));
 
+    // Earlier writes may have been in flight, they only report failure once waited on
+    out_file.flush();
     if (out_file.fail()) 
     {
         throw XGDException(ErrCode::FILE_WRITE, HERE(), "Failed to write to output file");  
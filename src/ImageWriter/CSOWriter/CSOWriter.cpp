@@ -1,63 +1,57 @@
 #include <cstring>
 
+#include <lz4.h>
+
 #include "AvlTree/AvlIterator.h"
 #include "ImageWriter/CSOWriter/CSOWriter.h"
 
-CSOWriter::CSOWriter(std::shared_ptr<ImageReader> image_reader, const ScrubType scrub_type) 
+namespace
+{
+    // Compression contexts belong to the pool threads and are reused by every CSOWriter
+    struct LZ4FContext
+    {
+        LZ4F_compressionContext_t ctx{nullptr};
+
+        LZ4FContext()
+        {
+            LZ4F_errorCode_t lz4f_error = LZ4F_createCompressionContext(&ctx, LZ4F_VERSION);
+            if (LZ4F_isError(lz4f_error)) 
+            {
+                throw XGDException(ErrCode::MISC, HERE(), LZ4F_getErrorName(lz4f_error));
+            }
+        }
+
+        ~LZ4FContext()
+        {
+            LZ4F_freeCompressionContext(ctx);
+        }
+    };
+}
+
+CSOWriter::CSOWriter(std::shared_ptr<ImageReader> image_reader, const ScrubType scrub_type, const CompressionPreset compression_preset, const int compression_level) 
     :   image_reader_(image_reader),
-        scrub_type_(scrub_type)
+        scrub_type_(scrub_type),
+        compress_level_(compression_preset, compression_level)
 {
     init_cso_writer();
 }
 
-CSOWriter::CSOWriter(const std::filesystem::path& in_dir_path)
-    :   in_dir_path_(in_dir_path)
+CSOWriter::CSOWriter(const std::filesystem::path& in_dir_path, const CompressionPreset compression_preset, const int compression_level)
+    :   in_dir_path_(in_dir_path),
+        compress_level_(compression_preset, compression_level)
 {
     init_cso_writer();
 }
 
-CSOWriter::~CSOWriter() 
+CSOWriter::CSOWriter(std::shared_ptr<ZARReader> zar_reader, const CompressionPreset compression_preset, const int compression_level)
+    :   ImageWriter(zar_reader),
+        compress_level_(compression_preset, compression_level)
 {
-    {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        stop_flag_ = true;
-    }
-
-    cv_.notify_all();
-
-    for (std::thread& thread : thread_pool_) 
-    {
-        if (thread.joinable()) 
-        {
-            thread.join();
-        }
-    }
-
-    for (auto& ctx : lz4f_ctx_pool_) 
-    {
-        LZ4F_freeCompressionContext(ctx);
-    }
+    init_cso_writer();
 }
 
 void CSOWriter::init_cso_writer() 
 {
-    for (uint32_t i = 0; i < std::min(std::thread::hardware_concurrency(), static_cast<uint32_t>(32)); ++i) 
-    {
-        // Pass i so each thread has a unique index and compression context
-        thread_pool_.emplace_back(&CSOWriter::thread_worker, this, i);
-    }
-
-    for (size_t i = 0; i < thread_pool_.size(); ++i)
-    {
-        lz4f_ctx_pool_.emplace_back(LZ4F_compressionContext_t());
-
-        LZ4F_errorCode_t lz4f_error = LZ4F_createCompressionContext(&lz4f_ctx_pool_.back(), LZ4F_VERSION);
-        if (LZ4F_isError(lz4f_error)) 
-        {
-            throw XGDException(ErrCode::MISC, HERE(), LZ4F_getErrorName(lz4f_error));
-        }
-    }
-
     lz4f_max_size_ = LZ4F_compressBound(Xiso::SECTOR_SIZE, &lz4f_prefs_);
 }
 
@@ -82,10 +76,19 @@ std::vector<std::filesystem::path> CSOWriter::convert(const std::filesystem::pat
         AvlTree avl_tree(in_dir_path_.filename().string(), in_dir_path_);
         convert_to_cso_from_avl(avl_tree);
     }
+    else if (zar_reader_)
+    {
+        AvlTree avl_tree(zar_reader_->name(), *zar_reader_);
+        convert_to_cso_from_avl(avl_tree);
+    }
     else if (!image_reader_)
     {
         throw XGDException(ErrCode::MISC, HERE(), "No input data to convert to CSO");
     }
+    else if (scrub_type_ == ScrubType::NONE && compress_level_.is_default() && image_reader_->lz4_block_format() == FileType::CCI)
+    {
+        transcode_to_cso();
+    }
     else
     {
         convert_to_cso(scrub_type_ == ScrubType::PARTIAL);
@@ -99,12 +102,16 @@ void CSOWriter::convert_to_cso(const bool scrub)
     ImageReader& image_reader = *image_reader_;
     uint32_t sector_offset = static_cast<uint32_t>(image_reader.image_offset() / Xiso::SECTOR_SIZE);
     uint32_t end_sector = image_reader.total_sectors();
-    const std::unordered_set<uint32_t>* data_sectors;
+    const SectorSet* data_sectors = nullptr;
 
     if (scrub) 
     {
-        data_sectors = &image_reader.data_sectors();
         end_sector = std::min(image_reader.max_data_sector() + 1, end_sector);
+
+        if (image_reader.platform() == Platform::OGX) 
+        {
+            data_sectors = &image_reader.data_sectors();
+        }
     }
 
     uint32_t sectors_to_write = end_sector - sector_offset;
@@ -112,59 +119,131 @@ void CSOWriter::convert_to_cso(const bool scrub)
     prog_total_ = sectors_to_write - 1;
     prog_processed_ = 0;
 
-    std::ofstream out_file(out_filepath_1_, std::ios::binary);
+    split::async_ofstream out_file(out_filepath_1_, std::ios::binary);
     if (!out_file.is_open()) 
     {
         throw XGDException(ErrCode::FILE_OPEN, HERE(), out_filepath_1_.string());
     }
 
+    out_cache_.open(out_filepath_1_);
+
     write_cso_header(out_file, sectors_to_write);
     write_dummy_index(out_file, sectors_to_write);
 
-    uint32_t current_sector = sector_offset;
-
     std::vector<uint32_t> block_index;
     block_index.reserve((end_sector - sector_offset) + 1);
 
-    uint32_t num_threads = static_cast<uint32_t>(thread_pool_.size());
-    std::vector<char> read_buffer(Xiso::SECTOR_SIZE * num_threads);
+    std::unique_ptr<CompressPipeline> pipeline = create_pipeline(out_file, block_index);
+
+    uint32_t batch_sectors = static_cast<uint32_t>(XGD::BULK_BUFFER_SIZE / Xiso::SECTOR_SIZE);
+
+    std::unique_ptr<SectorPrefetcher> prefetcher = prefetch_sectors_scrubbed(image_reader, sector_offset, end_sector, batch_sectors, data_sectors);
+    SectorPrefetcher::Batch batch;
 
     XGDLog() << "Writing CSO file" << XGDLog::Endl;
 
-    while (current_sector < end_sector) 
+    while (prefetcher->next(batch)) 
     {
-        uint32_t read_sectors = std::min(end_sector - current_sector, num_threads);
+        pipeline->submit(batch.data, batch.count);
+        
+        XGDLog().print_progress(prog_processed_ += batch.count, prog_total_);
 
-        for (uint32_t i = 0; i < read_sectors; ++i)
-        {
-            bool write_sector = true;
+        check_status_flags();
+    }
 
-            if (scrub && image_reader.platform() == Platform::OGX) 
-            {
-                write_sector = data_sectors->find(current_sector) != data_sectors->end();
-            }
+    pipeline->flush();
 
-            if (write_sector) 
-            {
-                image_reader.read_sector(current_sector, read_buffer.data() + (i * Xiso::SECTOR_SIZE));
-            } 
-            else 
-            {
-                std::memset(read_buffer.data() + (i * Xiso::SECTOR_SIZE), 0x00, Xiso::SECTOR_SIZE);
-            }
+    finalize_out_files(out_file, block_index);
+    out_file.close();
+    out_cache_.close();
+}
+
+/*  CCI and CSO images are both made of single LZ4 blocks, so each block is copied as is 
+    with only its framing rewritten. Everything happens on this thread, it's bound by I/O. */
+void CSOWriter::transcode_to_cso()
+{
+    ImageReader& image_reader = *image_reader_;
+    uint32_t total_sectors = image_reader.total_sectors();
 
-            current_sector++;
+    prog_total_ = total_sectors - 1;
+    prog_processed_ = 0;
+
+    split::async_ofstream out_file(out_filepath_1_, std::ios::binary);
+    if (!out_file.is_open()) 
+    {
+        throw XGDException(ErrCode::FILE_OPEN, HERE(), out_filepath_1_.string());
+    }
+
+    out_cache_.open(out_filepath_1_);
+
+    write_cso_header(out_file, total_sectors);
+    write_dummy_index(out_file, total_sectors);
+
+    out_position_ = static_cast<uint64_t>(out_file.tellp());
+
+    std::vector<uint32_t> block_index;
+    block_index.reserve(total_sectors + 1);
+
+    const uint32_t batch_sectors = static_cast<uint32_t>(XGD::BULK_BUFFER_SIZE / Xiso::SECTOR_SIZE);
+    const size_t out_stride = Xiso::SECTOR_SIZE + lz4f_max_size_;
+
+    std::vector<char> in_buffer;
+    std::vector<ImageReader::LZ4Block> blocks;
+    std::vector<char> out_buffer(batch_sectors * out_stride);
+    std::vector<CompressPipeline::Sector> sectors(batch_sectors);
+
+    XGDLog() << "Writing CSO file" << XGDLog::Endl;
+
+    for (uint32_t sector = 0; sector < total_sectors; sector += batch_sectors)
+    {
+        uint32_t count = std::min(batch_sectors, total_sectors - sector);
+
+        image_reader.read_lz4_blocks(sector, count, in_buffer, blocks);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            sectors[i] = transcode_block(in_buffer.data(), blocks[i], out_buffer.data() + (i * out_stride));
         }
 
-        compress_and_write_sectors_managed(out_file, block_index, read_sectors, read_buffer.data());
-        
-        XGDLog().print_progress(prog_processed_ += read_sectors, prog_total_);
+        write_sectors(out_file, block_index, sectors.data(), count);
+
+        XGDLog().print_progress(prog_processed_ += count, prog_total_);
 
         check_status_flags();
     }
 
     finalize_out_files(out_file, block_index);
     out_file.close();
+    out_cache_.close();
+}
+
+/*  out_buffer has room for a sector followed by a compressed one, for blocks that are too large 
+    to be stored compressed here and have to be decompressed and run through compress_sector. */
+CompressPipeline::Sector CSOWriter::transcode_block(const char* in_block, const ImageReader::LZ4Block& block, char* out_buffer)
+{
+    const char* block_data = in_block + block.offset;
+
+    if (!block.compressed)
+    {
+        return { block_data, Xiso::SECTOR_SIZE, false };
+    }
+
+    // Same limit as compress_sector, the size field is part of the block
+    if (block.size + sizeof(uint32_t) + 12 < Xiso::SECTOR_SIZE)
+    {
+        uint32_t block_size = block.size;
+        std::memcpy(out_buffer, &block_size, sizeof(uint32_t));
+        std::memcpy(out_buffer + sizeof(uint32_t), block_data, block.size);
+
+        return { out_buffer, static_cast<uint32_t>(block.size + sizeof(uint32_t)), true };
+    }
+
+    if (LZ4_decompress_safe(block_data, out_buffer, static_cast<int>(block.size), Xiso::SECTOR_SIZE) != Xiso::SECTOR_SIZE)
+    {
+        throw XGDException(ErrCode::MISC, HERE(), "LZ4_decompress_safe failed");
+    }
+
+    return compress_sector(out_buffer, out_buffer + Xiso::SECTOR_SIZE);
 }
 
 void CSOWriter::convert_to_cso_from_avl(AvlTree& avl_tree) 
@@ -176,35 +255,43 @@ void CSOWriter::convert_to_cso_from_avl(AvlTree& avl_tree)
 
     XGDLog() << "Writing CSO file" << XGDLog::Endl;
 
-    std::ofstream out_file(out_filepath_1_, std::ios::binary);
+    split::async_ofstream out_file(out_filepath_1_, std::ios::binary);
     if (!out_file.is_open()) 
     {
         throw XGDException(ErrCode::FILE_OPEN, HERE(), out_filepath_1_.string());
     }
 
+    out_cache_.open(out_filepath_1_);
+
     write_cso_header(out_file, out_iso_sectors);
     write_dummy_index(out_file, out_iso_sectors);
 
     std::vector<uint32_t> block_index;
     block_index.reserve(out_iso_sectors + 1);
+
+    std::unique_ptr<CompressPipeline> pipeline = create_pipeline(out_file, block_index);
+    uint32_t sectors_written = 0;
     
-    write_iso_header(out_file, block_index, avl_tree);
+    write_iso_header(*pipeline, avl_tree);
+    sectors_written += num_sectors(sizeof(Xiso::Header));
 
     AvlIterator avl_iterator(avl_tree);
     const std::vector<AvlIterator::Entry>& avl_entries = avl_iterator.entries();
 
     uint32_t pad_sectors = static_cast<uint32_t>((avl_entries.front().offset - sizeof(Xiso::Header)) / Xiso::SECTOR_SIZE);
-    write_padding_sectors(out_file, block_index, pad_sectors, 0x00);
+    write_padding_sectors(*pipeline, pad_sectors, 0x00);
+    sectors_written += pad_sectors;
 
     for (size_t i = 0; i < avl_entries.size(); i++) 
     {
-        if (avl_entries[i].offset > block_index.size() * Xiso::SECTOR_SIZE) 
+        if (avl_entries[i].offset > static_cast<uint64_t>(sectors_written) * Xiso::SECTOR_SIZE) 
         {
-            uint32_t pad_sectors = num_sectors(avl_entries[i].offset) - static_cast<uint32_t>(block_index.size());
-            write_padding_sectors(out_file, block_index, pad_sectors, Xiso::PAD_BYTE);
+            uint32_t pad_sectors = num_sectors(avl_entries[i].offset) - sectors_written;
+            write_padding_sectors(*pipeline, pad_sectors, Xiso::PAD_BYTE);
+            sectors_written += pad_sectors;
         } 
         
-        if (num_sectors(avl_entries[i].offset) != static_cast<uint32_t>(block_index.size()) || (avl_entries[i].offset % Xiso::SECTOR_SIZE)) 
+        if (num_sectors(avl_entries[i].offset) != sectors_written || (avl_entries[i].offset % Xiso::SECTOR_SIZE)) 
         {
             throw XGDException(ErrCode::MISC, HERE(), "CSO file has become misaligned");
         }
@@ -215,38 +302,43 @@ void CSOWriter::convert_to_cso_from_avl(AvlTree& avl_tree)
             size_t processed_entries = write_directory_to_buffer(avl_entries, i, entry_buffer);
             i += processed_entries - 1;
 
-            compress_and_write_sectors_managed(out_file, block_index, num_sectors(entry_buffer.size()), entry_buffer.data());
+            pipeline->submit(entry_buffer.data(), num_sectors(entry_buffer.size()));
+            sectors_written += num_sectors(entry_buffer.size());
         } 
         else 
         {
             if (image_reader_) 
             {
-                write_file_from_reader(out_file, block_index, *avl_entries[i].node);
+                write_file_from_reader(*pipeline, *avl_entries[i].node);
             } 
             else 
             {
-                write_file_from_directory(out_file, block_index, *avl_entries[i].node);
+                write_file_from_directory(*pipeline, *avl_entries[i].node);
             }
+
+            sectors_written += num_sectors(avl_entries[i].node->file_size);
         }
     }
 
-    if (block_index.size() < out_iso_sectors) 
+    if (sectors_written < out_iso_sectors) 
     {
-        uint32_t pad_sectors = out_iso_sectors - static_cast<uint32_t>(block_index.size());
-        write_padding_sectors(out_file, block_index, pad_sectors, 0x00);
+        write_padding_sectors(*pipeline, out_iso_sectors - sectors_written, 0x00);
     }
 
+    pipeline->flush();
+
     finalize_out_files(out_file, block_index);
 
     out_file.close();
+    out_cache_.close();
 }
 
-void CSOWriter::write_file_from_reader(std::ofstream& out_file, std::vector<uint32_t>& block_index, AvlTree::Node& node) 
+void CSOWriter::write_file_from_reader(CompressPipeline& pipeline, AvlTree::Node& node) 
 {
     ImageReader& image_reader = *image_reader_;
     uint64_t bytes_remaining = node.file_size;
     uint64_t read_position = image_reader.image_offset() + (node.old_start_sector * Xiso::SECTOR_SIZE);
-    std::vector<char> read_buffer(Xiso::SECTOR_SIZE * thread_pool_.size());
+    std::vector<char> read_buffer(XGD::BULK_BUFFER_SIZE);
 
     while (bytes_remaining > 0) 
     {
@@ -259,7 +351,7 @@ void CSOWriter::write_file_from_reader(std::ofstream& out_file, std::vector<uint
             std::memset(read_buffer.data() + read_size, Xiso::PAD_BYTE, Xiso::SECTOR_SIZE - (read_size % Xiso::SECTOR_SIZE));
         }
 
-        compress_and_write_sectors_managed(out_file, block_index, num_sectors(read_size), read_buffer.data());
+        pipeline.submit(read_buffer.data(), num_sectors(read_size));
 
         bytes_remaining -= read_size;
         read_position += read_size;
@@ -270,23 +362,19 @@ void CSOWriter::write_file_from_reader(std::ofstream& out_file, std::vector<uint
     }
 }
 
-void CSOWriter::write_file_from_directory(std::ofstream& out_file, std::vector<uint32_t>& block_index, AvlTree::Node& node) 
+void CSOWriter::write_file_from_directory(CompressPipeline& pipeline, AvlTree::Node& node) 
 {
-    std::ifstream in_file(node.path, std::ios::binary);
-    if (!in_file.is_open()) 
-    {
-        throw std::runtime_error("Failed to open input file: " + node.path.string());
-    }
+    std::unique_ptr<std::istream> in_file = open_tree_file(node);
 
     uint64_t bytes_remaining = node.file_size;
-    std::vector<char> read_buffer(Xiso::SECTOR_SIZE * thread_pool_.size());
+    std::vector<char> read_buffer(XGD::BULK_BUFFER_SIZE);
 
     while (bytes_remaining > 0) 
     {
         uint64_t read_size = std::min(bytes_remaining, read_buffer.size());
 
-        in_file.read(read_buffer.data(), read_size);
-        if (in_file.fail()) 
+        in_file->read(read_buffer.data(), read_size);
+        if (in_file->fail()) 
         {
             throw std::runtime_error("Failed to read from input file: " + node.path.string());
         }
@@ -296,7 +384,7 @@ void CSOWriter::write_file_from_directory(std::ofstream& out_file, std::vector<u
             std::memset(read_buffer.data() + read_size, Xiso::PAD_BYTE, Xiso::SECTOR_SIZE - (read_size % Xiso::SECTOR_SIZE));
         }
 
-        compress_and_write_sectors_managed(out_file, block_index, num_sectors(read_size), read_buffer.data());
+        pipeline.submit(read_buffer.data(), num_sectors(read_size));
 
         bytes_remaining -= read_size;
 
@@ -304,135 +392,100 @@ void CSOWriter::write_file_from_directory(std::ofstream& out_file, std::vector<u
 
         check_status_flags();
     }
-
-    in_file.close();
 }
 
-void CSOWriter::thread_worker(size_t thread_idx) 
+std::unique_ptr<CompressPipeline> CSOWriter::create_pipeline(split::async_ofstream& out_file, std::vector<uint32_t>& block_index)
 {
-    while (true) 
-    {
-        CompressTask task;
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-
-            cv_.wait(lock, [this] { return stop_flag_ || !task_queue_.empty(); });
-
-            if (stop_flag_ && task_queue_.empty()) 
-            {
-                return;
-            }
-
-            task = std::move(task_queue_.front());
-            task_queue_.pop();
-        }
-
-        size_t header_len = LZ4F_compressBegin(lz4f_ctx_pool_[thread_idx], task.out_buffer, Xiso::SECTOR_SIZE, &lz4f_prefs_);
-        if (LZ4F_isError(header_len)) 
-        {
-            task.promise.set_exception(std::make_exception_ptr(XGDException(ErrCode::MISC, HERE(), LZ4F_getErrorName(header_len))));
-        }
-
-        size_t compressed_size = LZ4F_compressUpdate(lz4f_ctx_pool_[thread_idx], task.out_buffer, lz4f_max_size_, task.in_buffer, Xiso::SECTOR_SIZE, nullptr);
-        if (LZ4F_isError(compressed_size)) 
-        {
-            task.promise.set_exception(std::make_exception_ptr(XGDException(ErrCode::MISC, HERE(), LZ4F_getErrorName(compressed_size))));
-        }
-
-        CompressedTaskResult result;
-        result.sector_idx = task.sector_idx;
-        result.compressed_size = compressed_size;
-        result.compressed = !((compressed_size == 0) || ((compressed_size + 12) >= Xiso::SECTOR_SIZE));
-        result.buffer_to_write = result.compressed ? task.out_buffer : task.in_buffer;
-
-        task.promise.set_value(result);
-    }
+    out_position_ = static_cast<uint64_t>(out_file.tellp());
+
+    return std::make_unique<CompressPipeline>(lz4f_max_size_, 
+        [this](const char* in_sector, char* out_buffer) {
+            return compress_sector(in_sector, out_buffer);
+        }, 
+        [this, &out_file, &block_index](const CompressPipeline::Sector* sectors, size_t count) {
+            write_sectors(out_file, block_index, sectors, count);
+        },
+        &compress_level_);
 }
 
-void CSOWriter::compress_and_write_sectors_managed(std::ofstream& out_file, std::vector<uint32_t>& block_index, const uint32_t num_sectors, const char* in_buffer)
+CompressPipeline::Sector CSOWriter::compress_sector(const char* in_sector, char* out_buffer) 
 {
-    std::vector<std::future<CompressedTaskResult>> futures;
-    std::vector<std::vector<char>> compress_buffers(num_sectors, std::vector<char>(lz4f_max_size_));
-
-    for (uint32_t i = 0; i < num_sectors; ++i)
-    {
-        std::promise<CompressedTaskResult> promise;
-        futures.emplace_back(promise.get_future());
+    thread_local LZ4FContext lz4f_context;
 
-        CompressTask task;
-        task.in_buffer = in_buffer + (i * Xiso::SECTOR_SIZE);
-        task.in_size = Xiso::SECTOR_SIZE;
-        task.out_buffer = compress_buffers[i].data();
-        task.sector_idx = i;
-        task.promise = std::move(promise);
+    // Levels below LZ4 HC's minimum make LZ4F use plain LZ4, the context keeps its state across level changes
+    LZ4F_preferences_t lz4f_prefs = lz4f_prefs_;
+    lz4f_prefs.compressionLevel = compress_level_.level(in_sector);
 
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            task_queue_.push(std::move(task));
-        }
-
-        cv_.notify_one();
-    }
-
-    std::vector<CompressedTaskResult> ordered_results;
-    ordered_results.reserve(num_sectors);
-
-    for (auto& future : futures)
+    size_t header_len = LZ4F_compressBegin(lz4f_context.ctx, out_buffer, Xiso::SECTOR_SIZE, &lz4f_prefs);
+    if (LZ4F_isError(header_len)) 
     {
-        ordered_results.push_back(future.get());
+        throw XGDException(ErrCode::MISC, HERE(), LZ4F_getErrorName(header_len));
     }
 
-    std::sort(ordered_results.begin(), ordered_results.end(), [](const CompressedTaskResult& a, const CompressedTaskResult& b) 
+    size_t compressed_size = LZ4F_compressUpdate(lz4f_context.ctx, out_buffer, lz4f_max_size_, in_sector, Xiso::SECTOR_SIZE, nullptr);
+    if (LZ4F_isError(compressed_size)) 
     {
-        return a.sector_idx < b.sector_idx;
-    });
+        throw XGDException(ErrCode::MISC, HERE(), LZ4F_getErrorName(compressed_size));
+    }
 
-    for (const auto& result : ordered_results)
+    if ((compressed_size == 0) || ((compressed_size + 12) >= Xiso::SECTOR_SIZE))
     {
-        write_sector(out_file, block_index, result);
+        return { in_sector, Xiso::SECTOR_SIZE, false };
     }
+    return { out_buffer, static_cast<uint32_t>(compressed_size), true };
 }
 
-void CSOWriter::write_sector(std::ofstream& out_file, std::vector<uint32_t>& block_index, const CompressedTaskResult& result) 
+void CSOWriter::write_sectors(split::async_ofstream& out_file, std::vector<uint32_t>& block_index, const CompressPipeline::Sector* sectors, size_t count) 
 {
-    if (static_cast<uint64_t>(out_file.tellp()) > CSO::SPLIT_OFFSET) 
+    for (size_t i = 0; i < count; ++i)
     {
-        out_file.close();
-        out_file = std::ofstream(out_filepath_2_, std::ios::binary);
-        if (!out_file.is_open()) 
+        if (out_position_ > CSO::SPLIT_OFFSET) 
         {
-            throw XGDException(ErrCode::FILE_OPEN, HERE(), out_filepath_2_.string());
+            out_file.close();
+            if (out_file.fail()) 
+            {
+                throw XGDException(ErrCode::FILE_WRITE, HERE(), out_filepath_1_.string());
+            }
+
+            out_file = split::async_ofstream(out_filepath_2_, std::ios::binary);
+            if (!out_file.is_open()) 
+            {
+                throw XGDException(ErrCode::FILE_OPEN, HERE(), out_filepath_2_.string());
+            }
+
+            out_cache_.open(out_filepath_2_);
+            out_position_ = 0;
         }
-    }
 
-    if (out_file.tellp() & ALIGN_M) 
-    {
-        auto padding = ALIGN_B - (out_file.tellp() & ALIGN_M);
-        std::vector<char> alignment_buffer(padding, 0);
-        out_file.write(alignment_buffer.data(), padding);
-    }
+        if (out_position_ & ALIGN_M) 
+        {
+            uint64_t padding = ALIGN_B - (out_position_ & ALIGN_M);
+            std::vector<char> alignment_buffer(padding, 0);
+            out_file.write(alignment_buffer.data(), padding);
+            out_position_ += padding;
+        }
 
-    uint32_t block_info = static_cast<uint32_t>(out_file.tellp() >> CSO::INDEX_ALIGNMENT);
+        uint32_t block_info = static_cast<uint32_t>(out_position_ >> CSO::INDEX_ALIGNMENT);
 
-    if (!result.compressed) 
-    {
-        out_file.write(result.buffer_to_write, Xiso::SECTOR_SIZE);
-    } 
-    else 
-    {
-        block_info |= 0x80000000;
-        out_file.write(result.buffer_to_write, result.compressed_size);
-    }
+        if (sectors[i].compressed) 
+        {
+            block_info |= 0x80000000;
+        }
 
-    if (out_file.fail())
-    {
-        throw std::runtime_error("Failed to write to output file");
+        out_file.write(sectors[i].data, sectors[i].size);
+        if (out_file.fail())
+        {
+            throw XGDException(ErrCode::FILE_WRITE, HERE(), "Failed to write to output file");
+        }
+
+        out_position_ += sectors[i].size;
+        block_index.push_back(block_info);
     }
 
-    block_index.push_back(block_info);
+    out_cache_.trim(out_position_);
 }
 
-void CSOWriter::write_cso_header(std::ofstream& out_file, const uint32_t total_sectors)
+void CSOWriter::write_cso_header(split::async_ofstream& out_file, const uint32_t total_sectors)
 {
     CSO::Header cso_header(static_cast<uint64_t>(total_sectors) * Xiso::SECTOR_SIZE);
 
@@ -443,7 +496,7 @@ void CSOWriter::write_cso_header(std::ofstream& out_file, const uint32_t total_s
     }
 }
 
-void CSOWriter::write_dummy_index(std::ofstream& out_file, const uint32_t total_sectors)
+void CSOWriter::write_dummy_index(split::async_ofstream& out_file, const uint32_t total_sectors)
 {
     std::vector<uint32_t> buffer(total_sectors + 1, 0);
 
@@ -454,23 +507,30 @@ void CSOWriter::write_dummy_index(std::ofstream& out_file, const uint32_t total_
     }
 }
 
-void CSOWriter::write_iso_header(std::ofstream& out_file, std::vector<uint32_t>& block_index, AvlTree& avl_tree)
+void CSOWriter::write_iso_header(CompressPipeline& pipeline, AvlTree& avl_tree)
 {
     Xiso::Header iso_header(static_cast<uint32_t>(avl_tree.root()->start_sector), 
                             static_cast<uint32_t>(avl_tree.root()->file_size), 
                             static_cast<uint32_t>(avl_tree.out_iso_size() / Xiso::SECTOR_SIZE), 
                             image_reader_ ? image_reader_->file_time() : Xiso::FileTime()); 
 
-    compress_and_write_sectors_managed(out_file, block_index, num_sectors(sizeof(Xiso::Header)), reinterpret_cast<const char*>(&iso_header));
+    pipeline.submit(reinterpret_cast<const char*>(&iso_header), num_sectors(sizeof(Xiso::Header)));
 }
 
-void CSOWriter::write_padding_sectors(std::ofstream& out_file, std::vector<uint32_t>& block_index, const uint32_t num_sectors, const char pad_byte)
+void CSOWriter::write_padding_sectors(CompressPipeline& pipeline, const uint32_t num_sectors, const char pad_byte)
 {
-    std::vector<char> padding(Xiso::SECTOR_SIZE * num_sectors, pad_byte);
-    compress_and_write_sectors_managed(out_file, block_index, num_sectors, padding.data());
+    const uint32_t buffer_sectors = static_cast<uint32_t>(XGD::BULK_BUFFER_SIZE / Xiso::SECTOR_SIZE);
+    std::vector<char> padding(static_cast<size_t>(std::min(num_sectors, buffer_sectors)) * Xiso::SECTOR_SIZE, pad_byte);
+
+    for (uint32_t sectors_remaining = num_sectors; sectors_remaining > 0; )
+    {
+        uint32_t count = std::min(sectors_remaining, buffer_sectors);
+        pipeline.submit(padding.data(), count);
+        sectors_remaining -= count;
+    }
 }
 
-void CSOWriter::finalize_out_files(std::ofstream& out_file, std::vector<uint32_t>& block_index) 
+void CSOWriter::finalize_out_files(split::async_ofstream& out_file, std::vector<uint32_t>& block_index) 
 {
     out_file.seekp(0, std::ios::end);
 
@@ -480,7 +540,12 @@ void CSOWriter::finalize_out_files(std::ofstream& out_file, std::vector<uint32_t
     if (std::filesystem::exists(out_filepath_2_)) 
     {
         out_file.close();
-        out_file = std::ofstream(out_filepath_1_, std::ios::binary | std::ios::in | std::ios::out);
+        if (out_file.fail()) 
+        {
+            throw XGDException(ErrCode::FILE_WRITE, HERE(), out_filepath_2_.string());
+        }
+
+        out_file = split::async_ofstream(out_filepath_1_, std::ios::binary | std::ios::in | std::ios::out);
         if (!out_file.is_open()) 
         {
             throw XGDException(ErrCode::FILE_OPEN, HERE(), out_filepath_1_.string());
@@ -497,10 +562,17 @@ void CSOWriter::finalize_out_files(std::ofstream& out_file, std::vector<uint32_t
     out_file.seekp(0, std::ios::end);
     pad_to_modulus(out_file, CSO::FILE_MODULUS, 0x00);
 
+    // Earlier writes may have been in flight, they only report failure once waited on
+    out_file.flush();
+    if (out_file.fail()) 
+    {
+        throw XGDException(ErrCode::FILE_WRITE, HERE(), out_filepath_1_.string());
+    }
+
     block_index.clear();
 }
 
-void CSOWriter::pad_to_modulus(std::ofstream& out_file, const uint64_t modulus, const char pad_byte) 
+void CSOWriter::pad_to_modulus(split::async_ofstream& out_file, const uint64_t modulus, const char pad_byte) 
 {
     if ((out_file.tellp() % modulus) == 0) 
     {
@@ -5,67 +5,47 @@
 #include <vector>
 #include <fstream>
 #include <filesystem>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
-#include <future>
+#include <memory>
 
 #include <lz4frame.h>
 
 #include "ImageReader/ImageReader.h"
 #include "ImageWriter/ImageWriter.h"
+#include "ImageWriter/CompressPipeline/CompressPipeline.h"
+#include "ImageWriter/CompressPipeline/CompressLevel.h"
 #include "Formats/CSO.h"
 #include "Formats/Xiso.h"
 #include "AvlTree/AvlTree.h"
+#include "SplitFStream/SplitFStream.h"
 #include "XGD.h"
 
 class CSOWriter : public ImageWriter {
 public:
-    CSOWriter(std::shared_ptr<ImageReader> image_reader, const ScrubType scrub_type);
-    CSOWriter(const std::filesystem::path& in_dir_path);
+    CSOWriter(std::shared_ptr<ImageReader> image_reader, const ScrubType scrub_type, const CompressionPreset compression_preset, const int compression_level);
+    CSOWriter(const std::filesystem::path& in_dir_path, const CompressionPreset compression_preset, const int compression_level);
+    CSOWriter(std::shared_ptr<ZARReader> zar_reader, const CompressionPreset compression_preset, const int compression_level);
     
-    ~CSOWriter();
+    ~CSOWriter() override = default;
 
     std::vector<std::filesystem::path> convert(const std::filesystem::path& out_cso_path);
 
 private:
-    struct CompressedTaskResult 
-    {
-        uint32_t sector_idx;
-        size_t compressed_size;
-        const char* buffer_to_write;
-        bool compressed;
-    };
-
-    struct CompressTask 
-    {
-        const char* in_buffer;
-        char* out_buffer;
-        int in_size;
-        std::promise<CompressedTaskResult> promise;
-        uint32_t sector_idx;
-    };
-
     const int ALIGN_B = 1 << CSO::INDEX_ALIGNMENT;
     const int ALIGN_M = ALIGN_B - 1;
 
-    std::vector<std::thread> thread_pool_;
-    std::queue<CompressTask> task_queue_;
-    std::mutex queue_mutex_;
-    std::condition_variable cv_;
-    std::atomic<bool> stop_flag_{false};
-
     std::shared_ptr<ImageReader> image_reader_{nullptr};
     std::filesystem::path in_dir_path_; 
 
     ScrubType scrub_type_{ScrubType::NONE};
+    CompressLevel compress_level_;
 
     std::filesystem::path out_filepath_base_;
     std::filesystem::path out_filepath_1_;
     std::filesystem::path out_filepath_2_;
+    split::cache_trimmer out_cache_; // Follows whichever part is being written
+    uint64_t out_position_{0}; // Write position in the current part, tracked so the writer never has to call tellp
 
     size_t lz4f_max_size_;
-    std::vector<LZ4F_compressionContext_t> lz4f_ctx_pool_;
     LZ4F_preferences_t lz4f_prefs_ = 
     { 
         { LZ4F_default, LZ4F_blockIndependent, LZ4F_noContentChecksum, LZ4F_frame, 0ULL, 0U, LZ4F_noBlockChecksum }, 
@@ -82,21 +62,23 @@ private:
 
     void convert_to_cso(const bool scrub);
     void convert_to_cso_from_avl(AvlTree& avl_tree);
+    void transcode_to_cso();
 
-    void write_iso_header(std::ofstream& out_file, std::vector<uint32_t>& block_index, AvlTree& avl_tree);
-    void write_file_from_reader(std::ofstream& out_file, std::vector<uint32_t>& block_index, AvlTree::Node& node);
-    void write_file_from_directory(std::ofstream& out_file, std::vector<uint32_t>& block_index, AvlTree::Node& node);
+    std::unique_ptr<CompressPipeline> create_pipeline(split::async_ofstream& out_file, std::vector<uint32_t>& block_index);
+    CompressPipeline::Sector compress_sector(const char* in_sector, char* out_buffer);
+    CompressPipeline::Sector transcode_block(const char* in_block, const ImageReader::LZ4Block& block, char* out_buffer);
+    void write_sectors(split::async_ofstream& out_file, std::vector<uint32_t>& block_index, const CompressPipeline::Sector* sectors, size_t count);
 
-    void write_cso_header(std::ofstream& out_file, const uint32_t total_sectors);
-    void write_dummy_index(std::ofstream& out_file, const uint32_t total_sectors);
-    void finalize_out_files(std::ofstream& out_file, std::vector<uint32_t>& block_index);
-    void write_padding_sectors(std::ofstream& out_file, std::vector<uint32_t>& block_index, const uint32_t num_sectors, const char pad_byte);
+    void write_iso_header(CompressPipeline& pipeline, AvlTree& avl_tree);
+    void write_file_from_reader(CompressPipeline& pipeline, AvlTree::Node& node);
+    void write_file_from_directory(CompressPipeline& pipeline, AvlTree::Node& node);
+    void write_padding_sectors(CompressPipeline& pipeline, const uint32_t num_sectors, const char pad_byte);
 
-    void compress_and_write_sectors_managed(std::ofstream& out_file, std::vector<uint32_t>& block_index, const uint32_t num_sectors, const char* in_buffer);
-    void write_sector(std::ofstream& out_file, std::vector<uint32_t>& block_index, const CompressedTaskResult& result);
-    void thread_worker(size_t thread_idx);
+    void write_cso_header(split::async_ofstream& out_file, const uint32_t total_sectors);
+    void write_dummy_index(split::async_ofstream& out_file, const uint32_t total_sectors);
+    void finalize_out_files(split::async_ofstream& out_file, std::vector<uint32_t>& block_index);
 
-    void pad_to_modulus(std::ofstream& out_file, const uint64_t modulus, const char pad_byte);
+    void pad_to_modulus(split::async_ofstream& out_file, const uint64_t modulus, const char pad_byte);
     std::vector<std::filesystem::path> out_paths();
 };
 
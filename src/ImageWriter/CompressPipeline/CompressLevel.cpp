@@ -0,0 +1,114 @@
+#include <algorithm>
+
+#include <lz4hc.h>
+
+#include "XGD.h"
+#include "Formats/Xiso.h"
+#include "WorkPool/WorkPool.h"
+#include "ImageWriter/CompressPipeline/CompressLevel.h"
+
+CompressLevel::CompressLevel(const CompressionPreset preset, const int hc_level)
+    :   preset_(preset),
+        hc_level_(hc_level),
+        window_start_(std::chrono::steady_clock::now())
+{
+    switch (preset_)
+    {
+        case CompressionPreset::FAST:
+            level_ = FAST_LEVEL;
+            break;
+        case CompressionPreset::HC:
+            level_ = (hc_level > 0) ? std::clamp(hc_level, LZ4HC_CLEVEL_MIN, LZ4HC_CLEVEL_MAX) : LZ4HC_CLEVEL_DEFAULT;
+            break;
+        default:
+            level_ = LZ4HC_CLEVEL_MAX;
+            break;
+    }
+}
+
+int CompressLevel::level(const char* in_sector) const
+{
+    if (adaptive() && looks_incompressible(in_sector))
+    {
+        return FAST_LEVEL;
+    }
+    return level_;
+}
+
+/*  Estimates the order 0 collision entropy of every SAMPLE_STRIDE'th byte, sectors above 7.5 bits
+    per byte are already compressed or encrypted data that HC would spend its time on for nothing. */
+bool CompressLevel::looks_incompressible(const char* in_sector)
+{
+    constexpr uint64_t num_samples = Xiso::SECTOR_SIZE / SAMPLE_STRIDE;
+
+    uint16_t counts[256] = {};
+
+    for (uint32_t i = 0; i < Xiso::SECTOR_SIZE; i += SAMPLE_STRIDE)
+    {
+        ++counts[static_cast<uint8_t>(in_sector[i])];
+    }
+
+    // Pairs of samples with the same value
+    uint64_t collisions = 0;
+
+    for (uint16_t count : counts)
+    {
+        collisions += static_cast<uint64_t>(count) * count;
+    }
+    collisions -= num_samples;
+
+    // Collision probability below 2^-7.5, 181 is 2^7.5 rounded down
+    return collisions * 181 < num_samples * (num_samples - 1);
+}
+
+void CompressLevel::add_compress_time(const uint64_t num_bytes, const uint64_t nanoseconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    compress_bytes_ += num_bytes;
+    compress_time_ += nanoseconds;
+}
+
+void CompressLevel::add_written(const uint64_t num_bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    written_bytes_ += num_bytes;
+
+    if (written_bytes_ >= ADJUST_BYTES)
+    {
+        adjust_level();
+    }
+}
+
+/*  Compares how fast the pool could compress at the current level with every thread busy against how fast
+    the output actually drained compressed data since the last adjustment, by the wall clock. The output 
+    can't drain faster than the pool compresses, so when it keeps pace with the pool's full rate compressing 
+    is what holds it back and the level is lowered. Uniform sectors are left out of both, they cost neither. */
+void CompressLevel::adjust_level()
+{
+    auto now = std::chrono::steady_clock::now();
+    uint64_t window_time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - window_start_).count());
+
+    double compress_rate = static_cast<double>(compress_bytes_) * WorkPool::shared().num_threads() / std::max(compress_time_, static_cast<uint64_t>(1));
+    double write_rate = static_cast<double>(written_bytes_) / std::max(window_time, static_cast<uint64_t>(1));
+    int level = level_;
+
+    if (write_rate * 10 >= compress_rate * 9 && level != FAST_LEVEL)
+    {
+        level = (level > LZ4HC_CLEVEL_MIN) ? level - 1 : FAST_LEVEL;
+    }
+    else if (compress_rate > write_rate * 2 && level != LZ4HC_CLEVEL_MAX)
+    {
+        level = (level == FAST_LEVEL) ? LZ4HC_CLEVEL_MIN : level + 1;
+    }
+
+    if (level != level_)
+    {
+        XGDLog(Debug) << "Compression level changed to " << level << XGDLog::Endl;
+        level_ = level;
+    }
+
+    compress_bytes_ = 0;
+    compress_time_ = 0;
+    written_bytes_ = 0;
+    window_start_ = now;
+}
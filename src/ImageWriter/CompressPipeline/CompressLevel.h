@@ -0,0 +1,56 @@
+#ifndef _COMPRESS_LEVEL_H_
+#define _COMPRESS_LEVEL_H_
+
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "InputHelper/Types.h"
+
+/*  Picks the LZ4 level each sector is compressed at for a CompressionPreset, FAST_LEVEL means plain LZ4 instead of HC.
+    In adaptive mode the level starts at the HC maximum and is stepped down while compressing can't keep up
+    with writing, and back up once it can with room to spare. Sectors that look incompressible from a sample
+    of their bytes skip HC altogether there, plain LZ4 finds whatever matches they have in a fraction of the time. */
+class CompressLevel
+{
+public:
+    static constexpr int FAST_LEVEL = 0;
+
+    CompressLevel(const CompressionPreset preset, const int hc_level);
+
+    CompressLevel(const CompressLevel&) = delete;
+    CompressLevel& operator=(const CompressLevel&) = delete;
+
+    bool adaptive() const { return preset_ == CompressionPreset::ADAPTIVE; }
+
+    // No preset or HC level was asked for, existing LZ4 blocks may be copied as they are
+    bool is_default() const { return preset_ == CompressionPreset::MAX && hc_level_ < 0; }
+
+    // Safe to call from any thread
+    int level(const char* in_sector) const;
+
+    /*  Called by CompressPipeline in adaptive mode with the compressed bytes of each batch, the time 
+        taken to compress them, and once they've been handed to the output. */
+    void add_compress_time(const uint64_t num_bytes, const uint64_t nanoseconds);
+    void add_written(const uint64_t num_bytes);
+
+private:
+    static constexpr uint64_t ADJUST_BYTES = 4 * 1024 * 1024; // Compressed bytes between level adjustments
+    static constexpr uint32_t SAMPLE_STRIDE = 4;
+
+    const CompressionPreset preset_;
+    const int hc_level_;
+    std::atomic<int> level_;
+
+    std::mutex mutex_;
+    uint64_t compress_bytes_{0};
+    uint64_t compress_time_{0};
+    uint64_t written_bytes_{0};
+    std::chrono::steady_clock::time_point window_start_;
+
+    void adjust_level();
+    static bool looks_incompressible(const char* in_sector);
+};
+
+#endif // _COMPRESS_LEVEL_H_
@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+
+#include "Formats/Xiso.h"
+#include "Utils/BufferUtils.h"
+#include "WorkPool/WorkPool.h"
+#include "ImageWriter/CompressPipeline/CompressPipeline.h"
+
+CompressPipeline::CompressPipeline(const size_t max_compressed_size, CompressFunction compress_function, WriteFunction write_function, CompressLevel* compress_level)
+    :   max_compressed_size_(max_compressed_size),
+        compress_function_(std::move(compress_function)),
+        write_function_(std::move(write_function)),
+        compress_level_((compress_level && compress_level->adaptive()) ? compress_level : nullptr),
+        slots_((WorkPool::shared().num_threads() * 2) + 2) // Enough for every thread to have one batch queued behind the one it's compressing
+{
+    for (Slot& slot : slots_)
+    {
+        slot.in_buffer.resize(static_cast<size_t>(BATCH_SECTORS) * Xiso::SECTOR_SIZE);
+        slot.out_buffer.resize(static_cast<size_t>(BATCH_SECTORS) * max_compressed_size_);
+        slot.sectors.resize(BATCH_SECTORS);
+    }
+
+    zero_sector_ = compress_uniform(0x00, zero_buffer_);
+    pad_sector_ = compress_uniform(Xiso::PAD_BYTE, pad_buffer_);
+}
+
+// The buffer holds the sector followed by room to compress it, either half may end up being written
+CompressPipeline::Sector CompressPipeline::compress_uniform(const uint8_t value, std::vector<char>& buffer)
+{
+    buffer.resize(Xiso::SECTOR_SIZE + max_compressed_size_);
+    std::memset(buffer.data(), value, Xiso::SECTOR_SIZE);
+
+    return compress_function_(buffer.data(), buffer.data() + Xiso::SECTOR_SIZE);
+}
+
+CompressPipeline::~CompressPipeline()
+{
+    stop_flag_ = true;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return tasks_in_flight_ == 0; });
+}
+
+void CompressPipeline::submit(const char* in_buffer, const uint32_t num_sectors)
+{
+    for (uint32_t i = 0; i < num_sectors; ++i)
+    {
+        Slot& slot = slots_[fill_sequence_ % slots_.size()];
+
+        if (slot.state != SlotState::FREE)
+        {
+            wait_until([&] { return slot.state == SlotState::FREE; });
+        }
+        check_error();
+
+        const char* in_sector = in_buffer + (static_cast<size_t>(i) * Xiso::SECTOR_SIZE);
+        const Sector* uniform_sector = find_uniform(in_sector);
+
+        if (uniform_sector)
+        {
+            slot.sectors[slot.count] = *uniform_sector;
+        }
+        else
+        {
+            std::memcpy(slot.in_buffer.data() + (static_cast<size_t>(slot.count) * Xiso::SECTOR_SIZE), in_sector, Xiso::SECTOR_SIZE);
+            slot.sectors[slot.count] = Sector();
+            ++slot.num_to_compress;
+        }
+
+        if (++slot.count == BATCH_SECTORS)
+        {
+            publish_filled(slot);
+        }
+    }
+}
+
+const CompressPipeline::Sector* CompressPipeline::find_uniform(const char* in_sector) const
+{
+    switch (static_cast<uint8_t>(in_sector[0]))
+    {
+        case 0x00:
+            return BufferUtils::is_zero(in_sector, Xiso::SECTOR_SIZE) ? &zero_sector_ : nullptr;
+        case Xiso::PAD_BYTE:
+            return BufferUtils::is_filled(in_sector, Xiso::SECTOR_SIZE, Xiso::PAD_BYTE) ? &pad_sector_ : nullptr;
+        default:
+            return nullptr;
+    }
+}
+
+void CompressPipeline::flush()
+{
+    check_error();
+
+    Slot& slot = slots_[fill_sequence_ % slots_.size()];
+
+    if (slot.state == SlotState::FREE && slot.count > 0)
+    {
+        publish_filled(slot);
+    }
+
+    const uint64_t end_sequence = fill_sequence_;
+
+    wait_until([&] { return written_sequence_ == end_sequence; });
+    check_error();
+}
+
+void CompressPipeline::publish_filled(Slot& slot)
+{
+    slot.sequence = fill_sequence_++;
+
+    // Nothing to compress, write it from here if it's next in line, otherwise whoever writes the batch before it will
+    if (slot.num_to_compress == 0)
+    {
+        slot.state = SlotState::COMPRESSED;
+
+        try
+        {
+            write_ready_batches();
+        }
+        catch (...)
+        {
+            set_error(std::current_exception());
+        }
+        return;
+    }
+
+    slot.state = SlotState::FILLED;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++tasks_in_flight_;
+    }
+
+    WorkPool::shared().submit([this, &slot] { compress_batch(slot); });
+}
+
+void CompressPipeline::compress_batch(Slot& slot)
+{
+    if (!stop_flag_)
+    {
+        try
+        {
+            auto start_time = std::chrono::steady_clock::now();
+            uint64_t compressed_bytes = 0;
+
+            for (uint32_t i = 0; i < slot.count; ++i)
+            {
+                if (!slot.sectors[i].data)
+                {
+                    slot.sectors[i] = compress_function_(slot.in_buffer.data() + (static_cast<size_t>(i) * Xiso::SECTOR_SIZE),
+                                                         slot.out_buffer.data() + (static_cast<size_t>(i) * max_compressed_size_));
+                    compressed_bytes += slot.sectors[i].size;
+                }
+            }
+
+            slot.compressed_bytes = compressed_bytes;
+
+            if (compress_level_)
+            {
+                compress_level_->add_compress_time(compressed_bytes, elapsed_ns(start_time));
+            }
+
+            slot.state = SlotState::COMPRESSED;
+            write_ready_batches();
+        }
+        catch (...)
+        {
+            set_error(std::current_exception());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    --tasks_in_flight_;
+    cv_.notify_all();
+}
+
+/*  Only one thread writes at a time, a task that finishes while another is writing leaves its batch 
+    to that writer, which checks for more once it lets go so no batch is left behind. */
+void CompressPipeline::write_ready_batches()
+{
+    while (!stop_flag_)
+    {
+        bool expected = false;
+        if (!writing_.compare_exchange_strong(expected, true))
+        {
+            return;
+        }
+
+        while (!stop_flag_)
+        {
+            Slot& slot = slots_[write_sequence_ % slots_.size()];
+
+            if (slot.state != SlotState::COMPRESSED || slot.sequence != write_sequence_)
+            {
+                break;
+            }
+
+            try
+            {
+                write_function_(slot.sectors.data(), slot.count);
+
+                if (compress_level_ && slot.compressed_bytes > 0)
+                {
+                    compress_level_->add_written(slot.compressed_bytes);
+                }
+            }
+            catch (...)
+            {
+                writing_ = false;
+                throw;
+            }
+
+            slot.count = 0;
+            slot.num_to_compress = 0;
+            slot.compressed_bytes = 0;
+            slot.state = SlotState::FREE;
+            written_sequence_ = ++write_sequence_;
+            notify_all();
+        }
+
+        const uint64_t next_sequence = write_sequence_;
+        writing_ = false;
+
+        Slot& next_slot = slots_[next_sequence % slots_.size()];
+        if (next_slot.state != SlotState::COMPRESSED || next_slot.sequence != next_sequence)
+        {
+            return;
+        }
+    }
+}
+
+uint64_t CompressPipeline::elapsed_ns(const std::chrono::steady_clock::time_point start_time)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count());
+}
+
+// Checks without the lock first, the lock is only taken to sleep
+void CompressPipeline::wait_until(const std::function<bool()>& ready)
+{
+    if (ready() || stop_flag_)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return ready() || stop_flag_; });
+}
+
+/*  Taking the lock before notifying makes sure a thread that has just
+    checked its condition is asleep in wait_until, so it can't miss the wakeup. */
+void CompressPipeline::notify_all()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    cv_.notify_all();
+}
+
+void CompressPipeline::set_error(std::exception_ptr error)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_)
+        {
+            error_ = error;
+        }
+        stop_flag_ = true;
+    }
+    cv_.notify_all();
+}
+
+void CompressPipeline::check_error()
+{
+    if (!stop_flag_)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_)
+    {
+        std::rethrow_exception(error_);
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef _COMPRESS_PIPELINE_H_
+#define _COMPRESS_PIPELINE_H_
+
+#include <cstdint>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <exception>
+
+#include "ImageWriter/CompressPipeline/CompressLevel.h"
+
+/*  Compresses a stream of sectors on the shared WorkPool and writes them back in submission order.
+    Submitted sectors are copied into a ring of fixed size batches, each full batch becomes one pool task,
+    and whichever task finishes the next batch in line writes every batch that's ready, one writer at a time,
+    so out of order batches wait in the ring until their turn. Slot states are atomics, 
+    the lock is only taken to sleep when the ring is full or while waiting for a flush.
+    Sectors filled with 0x00 or Xiso::PAD_BYTE, most of a scrubbed image, are compressed once when the
+    pipeline is created and reused, batches made up only of those are written without going through the pool. */
+class CompressPipeline
+{
+public:
+    struct Sector
+    {
+        const char* data{nullptr};
+        uint32_t size{0};
+        bool compressed{false};
+    };
+
+    /*  Compresses one sector into out_buffer, returns what should be written, either out_buffer 
+        or in_sector if the sector didn't compress. Called from pool threads, any state must be per thread. */
+    using CompressFunction = std::function<Sector(const char* in_sector, char* out_buffer)>;
+
+    // Writes a batch of sectors, calls never overlap and come in submission order
+    using WriteFunction = std::function<void(const Sector* sectors, size_t count)>;
+
+    /*  If compress_level is adaptive it's told how long each batch took to compress and when it's been written, 
+        it must outlive the pipeline. */
+    CompressPipeline(const size_t max_compressed_size, CompressFunction compress_function, WriteFunction write_function, CompressLevel* compress_level = nullptr);
+    ~CompressPipeline();
+
+    CompressPipeline(const CompressPipeline&) = delete;
+    CompressPipeline& operator=(const CompressPipeline&) = delete;
+
+    /*  Copies num_sectors sectors into the pipeline, blocks only while every slot in the ring is in use.
+        Errors from the workers or the writer are rethrown here and from flush. */
+    void submit(const char* in_buffer, const uint32_t num_sectors);
+
+    // Waits until everything submitted so far has been written
+    void flush();
+
+private:
+    static constexpr uint32_t BATCH_SECTORS = 32;
+
+    enum class SlotState { FREE, FILLED, COMPRESSED };
+
+    struct Slot
+    {
+        std::vector<char> in_buffer;
+        std::vector<char> out_buffer;
+        std::vector<Sector> sectors; // Uniform sectors are filled in by submit, the rest have no data until compressed
+        uint32_t count{0};
+        uint32_t num_to_compress{0};
+        uint64_t compressed_bytes{0}; // Size of the sectors compress_batch compressed, uniform sectors aren't counted
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<SlotState> state{SlotState::FREE};
+    };
+
+    const size_t max_compressed_size_;
+    CompressFunction compress_function_;
+    WriteFunction write_function_;
+    CompressLevel* compress_level_; // Only set when it's adaptive
+
+    std::vector<char> zero_buffer_;
+    std::vector<char> pad_buffer_;
+    Sector zero_sector_;
+    Sector pad_sector_;
+
+    std::vector<Slot> slots_;
+    uint64_t fill_sequence_{0}; // Batch being filled by submit
+    uint64_t write_sequence_{0}; // Next batch to write, only touched while holding writing_
+    std::atomic<uint64_t> written_sequence_{0}; // Batches written so far
+    std::atomic<bool> writing_{false};
+    size_t tasks_in_flight_{0}; // Guarded by mutex_, the pipeline can't be destroyed until its tasks finish
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> stop_flag_{false};
+    std::exception_ptr error_{nullptr};
+
+    void compress_batch(Slot& slot);
+    void write_ready_batches();
+
+    const Sector* find_uniform(const char* in_sector) const;
+    Sector compress_uniform(const uint8_t value, std::vector<char>& buffer);
+
+    void publish_filled(Slot& slot);
+    void wait_until(const std::function<bool()>& ready);
+    void notify_all();
+    void set_error(std::exception_ptr error);
+    void check_error();
+
+    static uint64_t elapsed_ns(const std::chrono::steady_clock::time_point start_time);
+};
+
+#endif // _COMPRESS_PIPELINE_H_
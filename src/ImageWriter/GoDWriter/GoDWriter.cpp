@@ -1,8 +1,11 @@
 #include <cctype>
 #include <cstring>
+#include <algorithm>
 
 #include "Utils/EndianUtils.h"
 #include "Utils/StringUtils.h"
+#include "Utils/HashUtils.h"
+#include "WorkPool/WorkPool.h"
 #include "AvlTree/AvlIterator.h"
 #include "ImageWriter/GoDWriter/GoDLiveHeader.h"
 #include "ImageWriter/GoDWriter/GoDWriter.h"
@@ -13,6 +16,9 @@ GoDWriter::GoDWriter(std::shared_ptr<ImageReader> image_reader, TitleHelper& tit
 GoDWriter::GoDWriter(const std::filesystem::path& in_dir_path, TitleHelper& title_helper)
     : in_dir_path_(in_dir_path), title_helper_(title_helper) {}
 
+GoDWriter::GoDWriter(std::shared_ptr<ZARReader> zar_reader, TitleHelper& title_helper)
+    : ImageWriter(zar_reader), title_helper_(title_helper) {}
+
 std::vector<std::filesystem::path> GoDWriter::convert(const std::filesystem::path& out_god_directory) 
 {
     std::string platform_str;
@@ -46,6 +52,11 @@ std::vector<std::filesystem::path> GoDWriter::convert(const std::filesystem::pat
         AvlTree avl_tree(in_dir_path_.filename().string(), in_dir_path_); 
         out_part_paths = write_data_files_from_avl(avl_tree, out_data_directory);  
     }
+    else if (zar_reader_) //Write from ZAR archive
+    {
+        AvlTree avl_tree(zar_reader_->name(), *zar_reader_); 
+        out_part_paths = write_data_files_from_avl(avl_tree, out_data_directory);  
+    }
     else if (!image_reader_)
     {
         throw XGDException(ErrCode::MISC, HERE(), "No input data");
@@ -55,15 +66,18 @@ std::vector<std::filesystem::path> GoDWriter::convert(const std::filesystem::pat
         out_part_paths = write_data_files(out_data_directory, scrub_type_ == ScrubType::PARTIAL);
     }
 
-    write_hashtables(out_part_paths);
-    SHA1Hash final_mht_hash = finalize_hashtables(out_part_paths);
+    // The master hashtables are written last, this drops them from the cache in streaming mode
+    for (auto& part_path : out_part_paths)
+    {
+        split::cache_trimmer(part_path).close();
+    }
 
-    write_live_header(live_header_path, out_part_paths, final_mht_hash);
+    write_live_header(live_header_path, out_part_paths, final_mht_hash_);
 
     return { out_god_directory };
 }
 
-void GoDWriter::write_iso_header(std::vector<std::unique_ptr<std::ofstream>>& out_files, AvlTree& avl_tree)
+void GoDWriter::write_iso_header(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, AvlTree& avl_tree)
 {
     Xiso::Header iso_header(static_cast<uint32_t>(avl_tree.root()->start_sector),
                             static_cast<uint32_t>(avl_tree.root()->file_size),
@@ -72,29 +86,46 @@ void GoDWriter::write_iso_header(std::vector<std::unique_ptr<std::ofstream>>& ou
 
     for (size_t i = 0; i < sizeof(Xiso::Header) / Xiso::SECTOR_SIZE; i++) 
     {
-        Remap remapped = remap_sector(i);
-        out_files[remapped.file_index]->seekp(remapped.offset, std::ios::beg);
-        out_files[remapped.file_index]->write(reinterpret_cast<const char*>(&iso_header) + (i * Xiso::SECTOR_SIZE), Xiso::SECTOR_SIZE);
-        if (out_files[remapped.file_index]->fail()) 
+        write_sector(out_files, i, reinterpret_cast<const char*>(&iso_header) + (i * Xiso::SECTOR_SIZE));
+    }
+}
+
+void GoDWriter::write_sector(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const uint64_t iso_sector, const char* sector)
+{
+    if (iso_sector < next_sector_)
+    {
+        throw XGDException(ErrCode::MISC, HERE(), "GoD sectors must be written in order");
+    }
+
+    // Sectors that are skipped are left zeroed
+    if (iso_sector > next_sector_)
+    {
+        std::vector<char> zero_sector(Xiso::SECTOR_SIZE, 0);
+
+        while (next_sector_ < iso_sector)
         {
-            throw XGDException(ErrCode::FILE_WRITE, HERE());
+            write_sector(out_files, next_sector_, zero_sector.data());
         }
     }
+
+    // Data blocks start after the sub hashtable block
+    std::memcpy(hash_group_.data() + GoD::BLOCK_SIZE + hash_group_fill_, sector, Xiso::SECTOR_SIZE);
+    hash_group_fill_ += Xiso::SECTOR_SIZE;
+    next_sector_++;
+
+    if (GoD::BLOCK_SIZE + hash_group_fill_ == hash_group_.size())
+    {
+        write_hash_group(out_files);
+    }
 }
 
-void GoDWriter::write_padding_sectors(std::vector<std::unique_ptr<std::ofstream>>& out_files, const uint32_t start_sector, const uint32_t num_sectors, const char pad_byte)
+void GoDWriter::write_padding_sectors(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const uint32_t start_sector, const uint32_t num_sectors, const char pad_byte)
 {
     std::vector<char> pad_sector(Xiso::SECTOR_SIZE, pad_byte);
 
     for (uint32_t i = 0; i < num_sectors; ++i) 
     {
-        Remap remapped = remap_sector(start_sector + i);
-        out_files[remapped.file_index]->seekp(remapped.offset, std::ios::beg);
-        out_files[remapped.file_index]->write(pad_sector.data(), Xiso::SECTOR_SIZE);
-        if (out_files[remapped.file_index]->fail()) 
-        {
-            throw XGDException(ErrCode::FILE_WRITE, HERE());
-        }
+        write_sector(out_files, start_sector + i, pad_sector.data());
     }
 }
 
@@ -109,11 +140,11 @@ std::vector<std::filesystem::path> GoDWriter::write_data_files_from_avl(AvlTree&
     uint32_t total_out_parts = num_parts(total_out_data_blocks);
 
     std::vector<std::filesystem::path> out_part_paths = get_part_paths(out_data_directory, total_out_parts);
-    std::vector<std::unique_ptr<std::ofstream>> out_files;
+    std::vector<std::unique_ptr<split::async_ofstream>> out_files;
 
     for (auto& part_path : out_part_paths) 
     {
-        out_files.push_back(std::make_unique<std::ofstream>(part_path, std::ios::binary));
+        out_files.push_back(std::make_unique<split::async_ofstream>(part_path, std::ios::binary));
         if (!out_files.back()->is_open()) 
         {
             throw XGDException(ErrCode::FILE_OPEN, HERE(), part_path.string());
@@ -122,6 +153,7 @@ std::vector<std::filesystem::path> GoDWriter::write_data_files_from_avl(AvlTree&
 
     XGDLog() << "Writing GoD data files" << XGDLog::Endl;
 
+    start_hash_groups(out_part_paths);
     write_iso_header(out_files, avl_tree);
 
     AvlIterator avl_iterator(avl_tree);
@@ -129,9 +161,6 @@ std::vector<std::filesystem::path> GoDWriter::write_data_files_from_avl(AvlTree&
 
     uint32_t current_out_sector = static_cast<uint32_t>(avl_entries.front().offset / Xiso::SECTOR_SIZE);
 
-    Remap remapped = remap_sector(current_out_sector);  
-    out_files[remapped.file_index]->seekp(remapped.offset, std::ios::beg);
-
     for (size_t i = 0; i < avl_entries.size(); ++i)
     {
         if (avl_entries[i].offset != static_cast<uint64_t>(current_out_sector) * Xiso::SECTOR_SIZE) 
@@ -147,14 +176,7 @@ std::vector<std::filesystem::path> GoDWriter::write_data_files_from_avl(AvlTree&
 
             for (size_t j = 0; j < entry_buffer.size(); j += Xiso::SECTOR_SIZE)
             {
-                Remap remapped = remap_sector(current_out_sector);
-                out_files[remapped.file_index]->seekp(remapped.offset, std::ios::beg); 
-                out_files[remapped.file_index]->write(entry_buffer.data() + j, Xiso::SECTOR_SIZE);
-                if (out_files[remapped.file_index]->fail()) 
-                {
-                    throw XGDException(ErrCode::FILE_WRITE, HERE());
-                }
-
+                write_sector(out_files, current_out_sector, entry_buffer.data() + j);
                 current_out_sector++;
             }
         }
@@ -186,179 +208,140 @@ std::vector<std::filesystem::path> GoDWriter::write_data_files_from_avl(AvlTree&
         write_padding_sectors(out_files, current_out_sector, pad_sectors, 0x00);
     }
 
-    for (auto& file : out_files) 
-    {
-        file->close();
-    }
+    finish_hash_groups(out_files, out_part_paths);
+
     return out_part_paths;
 }
 
-void GoDWriter::write_file_from_reader(std::vector<std::unique_ptr<std::ofstream>>& out_files, const AvlTree::Node& node)
+void GoDWriter::write_file_from_reader(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const AvlTree::Node& node)
 {
     uint64_t current_write_sector = node.start_sector;
     uint64_t read_position = image_reader_->image_offset() + (node.old_start_sector * Xiso::SECTOR_SIZE);
     uint64_t bytes_remaining = node.file_size;
 
-    std::vector<char> read_buffer(Xiso::SECTOR_SIZE);
+    std::vector<char> read_buffer(XGD::BULK_BUFFER_SIZE);
 
     while (bytes_remaining > 0)
     {
-        uint64_t read_size = std::min(bytes_remaining, Xiso::SECTOR_SIZE);   
+        uint64_t read_size = std::min(bytes_remaining, read_buffer.size());
 
         image_reader_->read_bytes(read_position, read_size, read_buffer.data());
 
-        if (read_size < Xiso::SECTOR_SIZE) 
-        {
-            std::memset(read_buffer.data() + read_size, Xiso::PAD_BYTE, Xiso::SECTOR_SIZE - read_size);
-        }
-
-        Remap remapped = remap_sector(current_write_sector);
-        out_files[remapped.file_index]->seekp(remapped.offset, std::ios::beg);
-        out_files[remapped.file_index]->write(read_buffer.data(), Xiso::SECTOR_SIZE);
-        if (out_files[remapped.file_index]->fail()) 
-        {
-            throw XGDException(ErrCode::FILE_WRITE, HERE());
-        }
+        write_sectors(out_files, current_write_sector, read_buffer.data(), read_size);
 
         XGDLog().print_progress(prog_processed_ += read_size, prog_total_);
 
         read_position += read_size;
         bytes_remaining -= read_size;
-        current_write_sector++;
+        current_write_sector += num_sectors(read_size);
 
         check_status_flags();
     }
 }
 
-void GoDWriter::write_file_from_directory(std::vector<std::unique_ptr<std::ofstream>>& out_files, const AvlTree::Node& node)
+void GoDWriter::write_file_from_directory(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const AvlTree::Node& node)
 {
-    std::ifstream in_file(node.path, std::ios::binary);
-    if (!in_file.is_open()) 
-    {
-        throw XGDException(ErrCode::FILE_OPEN, HERE());
-    }
+    std::unique_ptr<std::istream> in_file = open_tree_file(node);
 
     uint64_t current_write_sector = node.start_sector;
     uint64_t bytes_remaining = node.file_size;
-    std::vector<char> read_buffer(Xiso::SECTOR_SIZE);
+    std::vector<char> read_buffer(XGD::BULK_BUFFER_SIZE);
 
     while (bytes_remaining > 0)
     {
-        uint64_t read_size = std::min(bytes_remaining, Xiso::SECTOR_SIZE);   
+        uint64_t read_size = std::min(bytes_remaining, read_buffer.size());
 
-        in_file.read(read_buffer.data(), read_size);
-        if (in_file.fail()) 
+        in_file->read(read_buffer.data(), read_size);
+        if (in_file->fail()) 
         {
             throw XGDException(ErrCode::FILE_READ, HERE());
         }
 
-        if (read_size < Xiso::SECTOR_SIZE) 
-        {
-            std::memset(read_buffer.data() + read_size, Xiso::PAD_BYTE, Xiso::SECTOR_SIZE - read_size);
-        }
-
-        Remap remapped = remap_sector(current_write_sector);
-        out_files[remapped.file_index]->seekp(remapped.offset, std::ios::beg);
-        out_files[remapped.file_index]->write(read_buffer.data(), Xiso::SECTOR_SIZE);
-        if (out_files[remapped.file_index]->fail()) 
-        {
-            throw XGDException(ErrCode::FILE_WRITE, HERE());
-        }
+        write_sectors(out_files, current_write_sector, read_buffer.data(), read_size);
 
         XGDLog().print_progress(prog_processed_ += read_size, prog_total_);
 
         bytes_remaining -= read_size;
-        current_write_sector++;
+        current_write_sector += num_sectors(read_size);
 
         check_status_flags();
     }
+}
 
-    in_file.close();
+// Pads a partial last sector in place, buffer must have room for it
+void GoDWriter::write_sectors(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const uint64_t start_sector, char* buffer, const uint64_t size)
+{
+    if (size % Xiso::SECTOR_SIZE) 
+    {
+        std::memset(buffer + size, Xiso::PAD_BYTE, Xiso::SECTOR_SIZE - (size % Xiso::SECTOR_SIZE));
+    }
+
+    for (uint32_t i = 0; i < num_sectors(size); ++i)
+    {
+        write_sector(out_files, start_sector + i, buffer + (static_cast<size_t>(i) * Xiso::SECTOR_SIZE));
+    }
 }
 
 std::vector<std::filesystem::path> GoDWriter::write_data_files(const std::filesystem::path& out_data_directory, const bool scrub) 
 {
     ImageReader& image_reader = *image_reader_;
     uint32_t sector_offset = static_cast<uint32_t>(image_reader.image_offset() / Xiso::SECTOR_SIZE);
-    uint32_t last_sector = image_reader.total_sectors();
-    const std::unordered_set<uint32_t>* data_sectors;
+    uint32_t end_sector = image_reader.total_sectors();
+    const SectorSet* data_sectors = nullptr;
 
     if (scrub) 
     {
-        data_sectors = &image_reader.data_sectors();
-        last_sector = std::min(image_reader.max_data_sector(), last_sector);
+        end_sector = std::min(image_reader.max_data_sector() + 1, end_sector);
+
+        if (image_reader.platform() == Platform::OGX) //No need to zero out padding for Xbox 360
+        {
+            data_sectors = &image_reader.data_sectors();
+        }
     }
 
-    uint32_t total_out_sectors = last_sector - sector_offset;
+    uint32_t total_out_sectors = end_sector - sector_offset;
     uint32_t total_out_data_blocks = num_blocks(static_cast<size_t>(total_out_sectors) * Xiso::SECTOR_SIZE);
     uint32_t total_out_parts = num_parts(total_out_data_blocks);
 
-    prog_total_ = last_sector - sector_offset;
+    prog_total_ = total_out_sectors - 1;
     prog_processed_ = 0;
 
     XGDLog(Debug) << "Total data blocks: " << total_out_data_blocks << " total parts: " << total_out_parts << XGDLog::Endl;  
 
     std::vector<std::filesystem::path> out_part_paths = get_part_paths(out_data_directory, total_out_parts);
-    std::vector<std::unique_ptr<std::ofstream>> out_files;
+    std::vector<std::unique_ptr<split::async_ofstream>> out_files;
 
     for (auto& part_path : out_part_paths) 
     {
-        out_files.push_back(std::make_unique<std::ofstream>(part_path, std::ios::binary));
+        out_files.push_back(std::make_unique<split::async_ofstream>(part_path, std::ios::binary));
         if (!out_files.back()->is_open()) 
         {
             throw XGDException(ErrCode::FILE_OPEN, HERE(), part_path.string());
         }
     }
 
-    uint32_t current_sector = sector_offset;
-    std::vector<char> buffer(Xiso::SECTOR_SIZE);
+    const uint32_t batch_sectors = static_cast<uint32_t>(XGD::BULK_BUFFER_SIZE / Xiso::SECTOR_SIZE);
 
-    XGDLog() << "Writing data files" << XGDLog::Endl;
+    std::unique_ptr<SectorPrefetcher> prefetcher = prefetch_sectors_scrubbed(image_reader, sector_offset, end_sector, batch_sectors, data_sectors);
+    SectorPrefetcher::Batch batch;
 
-    while (current_sector <= last_sector) 
-    {
-        bool write_sector = true;
-
-        if (scrub && image_reader.platform() == Platform::OGX) //No need to zero out padding for Xbox 360
-        {
-            write_sector = data_sectors->find(current_sector) != data_sectors->end();
-        }
+    XGDLog() << "Writing data files" << XGDLog::Endl;
 
-        if (write_sector) 
-        {
-            image_reader.read_sector(current_sector, buffer.data());
-        } 
-        else 
-        {
-            std::memset(buffer.data(), 0x00, Xiso::SECTOR_SIZE);
-        }
+    start_hash_groups(out_part_paths);
 
-        Remap remapped = remap_sector(current_sector - sector_offset);
-        out_files[remapped.file_index]->seekp(remapped.offset, std::ios::beg);
-        out_files[remapped.file_index]->write(buffer.data(), buffer.size());
-        if (out_files[remapped.file_index]->fail()) 
+    while (prefetcher->next(batch)) 
+    {
+        for (uint32_t i = 0; i < batch.count; ++i) 
         {
-            throw XGDException(ErrCode::FILE_WRITE, HERE());
+            write_sector(out_files, batch.start_sector + i - sector_offset, batch.data + (static_cast<size_t>(i) * Xiso::SECTOR_SIZE));
         }
 
-        current_sector++;
-
-        XGDLog().print_progress(prog_processed_++, prog_total_);
+        XGDLog().print_progress(prog_processed_ += batch.count, prog_total_);
 
         check_status_flags();
     }
 
-    if (out_files.back()->tellp() % GoD::BLOCK_SIZE) 
-    {
-        size_t padding = GoD::BLOCK_SIZE - (out_files.back()->tellp() % GoD::BLOCK_SIZE);
-        std::vector<char> pad_buffer(padding, 0);
-        out_files.back()->write(pad_buffer.data(), pad_buffer.size());
-    }
-
-    for (auto& file : out_files) 
-    {
-        file->close();
-    }
+    finish_hash_groups(out_files, out_part_paths);
 
     return out_part_paths;
 }
@@ -378,125 +361,121 @@ std::vector<std::filesystem::path> GoDWriter::get_part_paths(const std::filesyst
     return out_part_paths;
 }
 
-void GoDWriter::write_hashtables(const std::vector<std::filesystem::path>& part_paths) 
+void GoDWriter::start_hash_groups(const std::vector<std::filesystem::path>& part_paths)
 {
-    /*  For each sub hashtable, each of it's following data blocks are hashed (204),
-        all those hashes are then written to the sub hashtable, 
-        each sub hashtable block's hash is then written to the master hashtable */
+    hash_group_.resize(static_cast<size_t>(GoD::DATA_BLOCKS_PER_SHT + 1) * GoD::BLOCK_SIZE);
+    hash_group_fill_ = 0;
+    next_sector_ = 0;
+    data_blocks_written_ = 0;
+    master_hashtables_.assign(part_paths.size(), std::vector<SHA1Hash>());
+    out_caches_.clear();
+
+    for (auto& part_path : part_paths)
+    {
+        out_caches_.emplace_back(part_path);
+    }
+}
 
-    prog_total_ = part_paths.size() - 1;
-    prog_processed_ = 0;
+/*  The group's data blocks are hashed into its sub hashtable block, zero padded to block size,
+    which is hashed in turn for the master hashtable. Groups never cross into the next part. */
+void GoDWriter::write_hash_group(std::vector<std::unique_ptr<split::async_ofstream>>& out_files)
+{
+    uint32_t num_blocks = hash_group_fill_ / GoD::BLOCK_SIZE;
+    uint32_t file_index = static_cast<uint32_t>(data_blocks_written_ / GoD::DATA_BLOCKS_PER_PART);
+    split::async_ofstream& out_file = *out_files[file_index];
 
-    XGDLog() << "Writing hash tables" << XGDLog::Endl;
+    std::memset(hash_group_.data(), 0, GoD::BLOCK_SIZE);
+    hash_blocks(hash_group_.data() + GoD::BLOCK_SIZE, num_blocks, reinterpret_cast<SHA1Hash*>(hash_group_.data()));
 
-    for (auto& part_path : part_paths) 
-    {
-        uint32_t blocks_left = num_blocks(std::filesystem::file_size(part_path));
-        uint32_t sub_hashtables = (blocks_left - 1) / (GoD::DATA_BLOCKS_PER_SHT + 1) + ((blocks_left - 1) % (GoD::DATA_BLOCKS_PER_SHT + 1) ? 1 : 0);
+    master_hashtables_[file_index].push_back(compute_sha1(hash_group_.data(), GoD::BLOCK_SIZE));
 
-        std::fstream current_file(part_path, std::ios::binary | std::ios::in | std::ios::out);
-        if (!current_file.is_open()) 
+    // Room for the master hashtable, it's written once every part is done
+    if (master_hashtables_[file_index].size() == 1)
+    {
+        // Parts are written one after another, closing the last one frees its write buffers
+        if (file_index > 0)
         {
-            throw XGDException(ErrCode::FILE_OPEN, HERE(), part_path.string());
+            close_part(*out_files[file_index - 1]);
+            out_caches_[file_index - 1].close();
         }
 
-        current_file.seekp(GoD::BLOCK_SIZE, std::ios::beg);
-        blocks_left--;
-
-        std::vector<SHA1Hash> master_hashtable;
-
-        for (uint32_t i = 0; i < sub_hashtables; ++i) 
-        {
-            uint32_t blocks_in_sht = 0;
-            std::vector<char> block_buffer(GoD::BLOCK_SIZE, 0);
-            std::vector<SHA1Hash> sub_hashtable;
+        std::vector<char> mht_placeholder(GoD::BLOCK_SIZE, 0);
+        out_file.write(mht_placeholder.data(), GoD::BLOCK_SIZE);
+    }
 
-            current_file.seekp(GoD::BLOCK_SIZE, std::ios::cur);
-            blocks_left--;
+    out_file.write(hash_group_.data(), GoD::BLOCK_SIZE + (static_cast<size_t>(num_blocks) * GoD::BLOCK_SIZE));
+    if (out_file.fail()) 
+    {
+        throw XGDException(ErrCode::FILE_WRITE, HERE());
+    }
 
-            while (blocks_in_sht < GoD::DATA_BLOCKS_PER_SHT && 0 < blocks_left) 
-            {
-                current_file.read(block_buffer.data(), block_buffer.size());
-                if (current_file.fail()) 
-                {
-                    throw XGDException(ErrCode::FILE_READ, HERE());
-                }
+    out_caches_[file_index].trim(out_file.tellp());
 
-                sub_hashtable.push_back(compute_sha1(block_buffer.data(), block_buffer.size()));
+    data_blocks_written_ += num_blocks;
+    hash_group_fill_ = 0;
+}
 
-                blocks_in_sht++;
-                blocks_left--;
-            }
+// Each task hashes a run of blocks into its own slots, so the result doesn't depend on which thread gets there first
+void GoDWriter::hash_blocks(const char* data, const uint32_t num_blocks, SHA1Hash* out_hashes)
+{
+    constexpr uint32_t BLOCKS_PER_TASK = 12;
 
-            uint64_t position = current_file.tellp();
+    WorkPool::shared().run((num_blocks + BLOCKS_PER_TASK - 1) / BLOCKS_PER_TASK, [&](size_t task_idx) 
+    {
+        uint32_t first_block = static_cast<uint32_t>(task_idx) * BLOCKS_PER_TASK;
+        uint32_t task_blocks = std::min(BLOCKS_PER_TASK, num_blocks - first_block);
 
-            current_file.seekp((i * (GoD::DATA_BLOCKS_PER_SHT + 1) * GoD::BLOCK_SIZE) + GoD::BLOCK_SIZE, std::ios::beg);
-            current_file.write(reinterpret_cast<const char*>(sub_hashtable.data()), sub_hashtable.size() * sizeof(SHA1Hash));
-            current_file.seekp(position, std::ios::beg);
+        HashUtils::sha1_blocks(data + (static_cast<size_t>(first_block) * GoD::BLOCK_SIZE), GoD::BLOCK_SIZE, task_blocks, out_hashes[first_block].hash);
+    });
+}
 
-            // Zero padded to block size, then hashed 
-            std::vector<char> sub_hashtable_buffer(GoD::BLOCK_SIZE, 0);
-            std::memcpy(sub_hashtable_buffer.data(), sub_hashtable.data(), std::min(sub_hashtable.size() * sizeof(SHA1Hash), static_cast<size_t>(GoD::BLOCK_SIZE)));
-            master_hashtable.push_back(compute_sha1(sub_hashtable_buffer.data(), GoD::BLOCK_SIZE));
+/*  Pads out the last data block and writes the last hash group. Each Data file's master hashtable
+    ends with the hash of the next Data file's master hashtable, so they're written from the last one back.
+    The first Data file's master hashtable hash (final_mht_hash_) is written to the Live header file */
+void GoDWriter::finish_hash_groups(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const std::vector<std::filesystem::path>& part_paths)
+{
+    if (hash_group_fill_ % GoD::BLOCK_SIZE)
+    {
+        std::vector<char> zero_sector(Xiso::SECTOR_SIZE, 0);
 
-            if (blocks_left == 0) 
-            {
-                break;
-            }
+        while (hash_group_fill_ % GoD::BLOCK_SIZE)
+        {
+            write_sector(out_files, next_sector_, zero_sector.data());
         }
+    }
 
-        current_file.seekp(0, std::ios::beg);
-        current_file.write(reinterpret_cast<const char*>(master_hashtable.data()), master_hashtable.size() * sizeof(SHA1Hash));
-        current_file.close();
-
-        XGDLog().print_progress(prog_processed_++, prog_total_);
+    if (hash_group_fill_ > 0)
+    {
+        write_hash_group(out_files);
     }
-}
 
-GoDWriter::SHA1Hash GoDWriter::finalize_hashtables(const std::vector<std::filesystem::path>& part_paths) 
-{
-    /*  Each Data file's master hashtable block is hashed, then that's 
-        written to the end of the previous Data file's master hashtable. 
-        The first Data file's master hashtable hash (final_mht_hash) 
-        is written to the Live header file */
+    for (auto& out_file : out_files)
+    {
+        close_part(*out_file);
+    }
+    out_caches_.clear();
 
-    SHA1Hash final_mht_hash;
+    std::vector<char> master_hashtable_buffer(GoD::BLOCK_SIZE, 0);
 
-    for (size_t i = part_paths.size() - 1; i > 0; i--) 
+    for (size_t i = part_paths.size(); i-- > 0; ) 
     {
-        std::ifstream current_part = std::ifstream(part_paths[i], std::ios::binary);
-        if (!current_part.is_open()) 
-        {
-            throw XGDException(ErrCode::FILE_OPEN, HERE(), part_paths[i].string());
-        }
+        // The next part's hash is already in the last slot, the last part leaves it zeroed
+        std::memcpy(master_hashtable_buffer.data(), master_hashtables_[i].data(), master_hashtables_[i].size() * sizeof(SHA1Hash));
 
-        std::fstream prev_part = std::fstream(part_paths[i - 1], std::ios::binary | std::ios::in | std::ios::out);
-        if (!prev_part.is_open()) 
+        split::async_ofstream part_file(part_paths[i], std::ios::binary | std::ios::in | std::ios::out);
+        if (!part_file.is_open()) 
         {
-            throw XGDException(ErrCode::FILE_OPEN, HERE(), part_paths[i - 1].string());
+            throw XGDException(ErrCode::FILE_OPEN, HERE(), part_paths[i].string());
         }
 
-        std::vector<char> current_hash_buffer(GoD::BLOCK_SIZE, 0);
-        current_part.read(current_hash_buffer.data(), GoD::BLOCK_SIZE);
-
-        SHA1Hash current_mht_hash = compute_sha1(reinterpret_cast<const char*>(current_hash_buffer.data()), GoD::BLOCK_SIZE);
+        part_file.write(master_hashtable_buffer.data(), GoD::BLOCK_SIZE);
+        close_part(part_file);
 
-        prev_part.seekp(SHA_DIGEST_LENGTH * GoD::SHT_PER_MHT, std::ios::beg);
-        prev_part.write(reinterpret_cast<const char*>(&current_mht_hash.hash), SHA_DIGEST_LENGTH);
+        final_mht_hash_ = compute_sha1(master_hashtable_buffer.data(), GoD::BLOCK_SIZE);
 
-        if (i == 1) 
-        {
-            std::vector<char> last_mht(GoD::BLOCK_SIZE, 0);
-            prev_part.seekg(0, std::ios::beg);
-            prev_part.read(last_mht.data(), GoD::BLOCK_SIZE);
-            final_mht_hash = compute_sha1(last_mht.data(), GoD::BLOCK_SIZE);
-        }
-
-        current_part.close();
-        prev_part.close();
+        std::memset(master_hashtable_buffer.data(), 0, GoD::BLOCK_SIZE);
+        std::memcpy(master_hashtable_buffer.data() + (SHA_DIGEST_LENGTH * GoD::SHT_PER_MHT), final_mht_hash_.hash, SHA_DIGEST_LENGTH);
     }
-
-    return final_mht_hash;
 }
 
 void GoDWriter::write_live_header(const std::filesystem::path& out_header_path, const std::vector<std::filesystem::path>& out_part_paths, const SHA1Hash& final_mht_hash) 
@@ -583,40 +562,25 @@ void GoDWriter::write_live_header(const std::filesystem::path& out_header_path,
     out_file.close();
 }
 
-GoDWriter::Remap GoDWriter::remap_sector(const uint64_t iso_sector) 
+// Writes still in flight may only fail once they're waited on
+void GoDWriter::close_part(split::async_ofstream& out_file)
 {
-    uint64_t block_num = (iso_sector * Xiso::SECTOR_SIZE) / GoD::BLOCK_SIZE;
-    uint32_t file_index = static_cast<uint32_t>(block_num / GoD::DATA_BLOCKS_PER_PART);
-    uint64_t data_block_within_file = block_num % GoD::DATA_BLOCKS_PER_PART;
-    uint32_t hash_index = static_cast<uint32_t>(data_block_within_file / GoD::DATA_BLOCKS_PER_SHT);
-
-    uint64_t remapped_offset = GoD::BLOCK_SIZE; // master hashtable
-    remapped_offset += ((hash_index + 1) * GoD::BLOCK_SIZE); // Add subhash table blocks
-    remapped_offset += (data_block_within_file * GoD::BLOCK_SIZE); // Add data blocks
-    remapped_offset += (iso_sector * Xiso::SECTOR_SIZE) % GoD::BLOCK_SIZE; // Add offset within data block
-    return { remapped_offset, file_index };
-}
-
-GoDWriter::Remap GoDWriter::remap_offset(const uint64_t iso_offset) 
-{
-    Remap remapped = remap_sector(iso_offset / Xiso::SECTOR_SIZE);
-    remapped.offset += (iso_offset % Xiso::SECTOR_SIZE);
-    return { remapped.offset, remapped.file_index };
-}
+    if (!out_file.is_open())
+    {
+        return;
+    }
 
-uint64_t GoDWriter::to_iso_offset(const uint64_t god_offset, const uint32_t god_file_index) 
-{
-    auto block_num = god_offset / GoD::BLOCK_SIZE;
-    auto previous_data_blocks = god_file_index * GoD::DATA_BLOCKS_PER_PART;
-    auto sub_hash_index = block_num / (GoD::DATA_BLOCKS_PER_SHT + 1);
-    auto data_block_num = block_num - (sub_hash_index + 2) + previous_data_blocks;
-    return (data_block_num * GoD::BLOCK_SIZE) + (god_offset % GoD::BLOCK_SIZE);
+    out_file.close();
+    if (out_file.fail()) 
+    {
+        throw XGDException(ErrCode::FILE_WRITE, HERE());
+    }
 }
 
 GoDWriter::SHA1Hash GoDWriter::compute_sha1(const char* data, const uint64_t size) 
 {
     SHA1Hash result;
-    SHA1(reinterpret_cast<const unsigned char*>(data), size, result.hash);
+    HashUtils::sha1(data, size, result.hash);
     return result;
 }
 
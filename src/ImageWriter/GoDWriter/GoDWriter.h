@@ -17,6 +17,7 @@
 #include "Formats/GoD.h"
 #include "AvlTree/AvlTree.h"
 #include "AvlTree/AvlIterator.h"
+#include "SplitFStream/SplitFStream.h"
 #include "ImageReader/ImageReader.h"
 #include "ImageWriter/ImageWriter.h"
 #include "TitleHelper/TitleHelper.h"
@@ -25,6 +26,7 @@ class GoDWriter : public ImageWriter {
 public:
     GoDWriter(std::shared_ptr<ImageReader> image_reader, TitleHelper& title_helper, const ScrubType scrub_type);
     GoDWriter(const std::filesystem::path& in_dir_path, TitleHelper& title_helper);
+    GoDWriter(std::shared_ptr<ZARReader> zar_reader, TitleHelper& title_helper);
 
     ~GoDWriter() override = default;
 
@@ -36,11 +38,6 @@ private:
     };
     static_assert(sizeof(SHA1Hash) == SHA_DIGEST_LENGTH, "SHA1Hash size mismatch");
 
-    struct Remap {
-        uint64_t offset;
-        uint32_t file_index;
-    };
-
     std::shared_ptr<ImageReader> image_reader_{nullptr};
     std::filesystem::path in_dir_path_;
     TitleHelper& title_helper_;
@@ -49,26 +46,40 @@ private:
     uint64_t prog_total_{0};
     uint64_t prog_processed_{0};
 
+    /*  Parts are assembled a hash group at a time, a sub hashtable block followed by its data blocks,
+        each group is hashed and written in one go once it's full so the parts are written sequentially */
+    std::vector<char> hash_group_;
+    uint32_t hash_group_fill_{0}; // Bytes of data blocks in hash_group_
+    uint64_t next_sector_{0};
+    uint64_t data_blocks_written_{0};
+    std::vector<std::vector<SHA1Hash>> master_hashtables_; // Sub hashtable hashes, one table per part
+    std::vector<split::cache_trimmer> out_caches_; // One per part, trimmed as its groups are written
+    SHA1Hash final_mht_hash_;
+
     //Either no or partial scrubbing
     std::vector<std::filesystem::path> write_data_files(const std::filesystem::path& out_data_directory, const bool scrub);
 
     //Full scrub/write from directory
     std::vector<std::filesystem::path> write_data_files_from_avl(AvlTree& avl_tree, const std::filesystem::path& out_data_directory);
-    void write_iso_header(std::vector<std::unique_ptr<std::ofstream>>& out_files, AvlTree& avl_tree);
-    void write_file_from_reader(std::vector<std::unique_ptr<std::ofstream>>& out_files, const AvlTree::Node& node);
-    void write_file_from_directory(std::vector<std::unique_ptr<std::ofstream>>& out_files, const AvlTree::Node& node);
+    void write_iso_header(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, AvlTree& avl_tree);
+    void write_file_from_reader(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const AvlTree::Node& node);
+    void write_file_from_directory(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const AvlTree::Node& node);
     
+    //Hash groups
+    void start_hash_groups(const std::vector<std::filesystem::path>& part_paths);
+    void write_hash_group(std::vector<std::unique_ptr<split::async_ofstream>>& out_files);
+    void hash_blocks(const char* data, const uint32_t num_blocks, SHA1Hash* out_hashes);
+    void finish_hash_groups(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const std::vector<std::filesystem::path>& part_paths);
+
     //Finalize out files
-    void write_hashtables(const std::vector<std::filesystem::path>& part_paths);
-    SHA1Hash finalize_hashtables(const std::vector<std::filesystem::path>& part_paths);
     void write_live_header(const std::filesystem::path& out_header_path, const std::vector<std::filesystem::path>& out_part_paths, const SHA1Hash& final_mht_hash);
 
     //Helpers
     std::vector<std::filesystem::path> get_part_paths(const std::filesystem::path& out_directory, const uint32_t num_files);
-    void write_padding_sectors(std::vector<std::unique_ptr<std::ofstream>>& out_files, const uint32_t start_sector, const uint32_t num_sectors, const char pad_byte); 
-    Remap remap_sector(const uint64_t iso_sector);
-    Remap remap_offset(const uint64_t iso_offset);
-    uint64_t to_iso_offset(const uint64_t god_offset, const uint32_t god_file_index);
+    void close_part(split::async_ofstream& out_file);
+    void write_sector(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const uint64_t iso_sector, const char* sector);
+    void write_sectors(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const uint64_t start_sector, char* buffer, const uint64_t size);
+    void write_padding_sectors(std::vector<std::unique_ptr<split::async_ofstream>>& out_files, const uint32_t start_sector, const uint32_t num_sectors, const char pad_byte); 
     uint32_t num_blocks(const uint64_t num_bytes);
     uint32_t num_parts(const uint32_t num_data_blocks);
     SHA1Hash compute_sha1(const char* data, const uint64_t size);
@@ -1,5 +1,7 @@
 #include <algorithm>
+#include <cstring>
 #include <memory>
+#include <fstream>
 
 #include "Utils/EndianUtils.h"
 #include "ImageWriter/CCIWriter/CCIWriter.h"
@@ -11,21 +13,35 @@
 
 std::unique_ptr<ImageWriter> ImageWriter::create_instance(std::shared_ptr<ImageReader> image_reader, TitleHelper& title_helper, const OutputSettings& out_settings) 
 {
+    std::unique_ptr<ImageWriter> image_writer;
+
     switch (out_settings.file_type) 
     {
         case FileType::ISO:
-            return std::make_unique<XisoWriter>(image_reader, out_settings.scrub_type, out_settings.split);
+            image_writer = std::make_unique<XisoWriter>(image_reader, out_settings.scrub_type, out_settings.split);
+            break;
         case FileType::ZAR:
-            return std::make_unique<ZARWriter>(image_reader);
+            image_writer = std::make_unique<ZARWriter>(image_reader);
+            break;
         case FileType::GoD:
-            return std::make_unique<GoDWriter>(image_reader, title_helper, out_settings.scrub_type);
+            image_writer = std::make_unique<GoDWriter>(image_reader, title_helper, out_settings.scrub_type);
+            break;
         case FileType::CSO:
-            return std::make_unique<CSOWriter>(image_reader, out_settings.scrub_type);
+            image_writer = std::make_unique<CSOWriter>(image_reader, out_settings.scrub_type, out_settings.compression_preset, out_settings.compression_level);
+            break;
         case FileType::CCI:
-            return std::make_unique<CCIWriter>(image_reader, out_settings.scrub_type);
+            image_writer = std::make_unique<CCIWriter>(image_reader, out_settings.scrub_type, out_settings.compression_preset, out_settings.compression_level);
+            break;
         default:
             throw XGDException(ErrCode::ISO_INVALID, HERE(), "Unknown file type");
     }
+
+    if (out_settings.prefetch_sectors >= 0)
+    {
+        image_writer->set_prefetch_depth(static_cast<size_t>(out_settings.prefetch_sectors));
+    }
+
+    return image_writer;
 }
 
 std::unique_ptr<ImageWriter> ImageWriter::create_instance(const std::filesystem::path& in_dir_path, TitleHelper& title_helper, const OutputSettings& out_settings) 
@@ -39,9 +55,28 @@ std::unique_ptr<ImageWriter> ImageWriter::create_instance(const std::filesystem:
         case FileType::GoD:
             return std::make_unique<GoDWriter>(in_dir_path, title_helper);
         case FileType::CSO:
-            return std::make_unique<CSOWriter>(in_dir_path);
+            return std::make_unique<CSOWriter>(in_dir_path, out_settings.compression_preset, out_settings.compression_level);
         case FileType::CCI:
-            return std::make_unique<CCIWriter>(in_dir_path);
+            return std::make_unique<CCIWriter>(in_dir_path, out_settings.compression_preset, out_settings.compression_level);
+        default:
+            throw XGDException(ErrCode::ISO_INVALID, HERE(), "Unknown file type");
+    }
+}
+
+std::unique_ptr<ImageWriter> ImageWriter::create_instance(std::shared_ptr<ZARReader> zar_reader, TitleHelper& title_helper, const OutputSettings& out_settings) 
+{
+    switch (out_settings.file_type) 
+    {
+        case FileType::ISO:
+            return std::make_unique<XisoWriter>(zar_reader, out_settings.split);
+        case FileType::ZAR:
+            return std::make_unique<ZARWriter>(zar_reader);
+        case FileType::GoD:
+            return std::make_unique<GoDWriter>(zar_reader, title_helper);
+        case FileType::CSO:
+            return std::make_unique<CSOWriter>(zar_reader, out_settings.compression_preset, out_settings.compression_level);
+        case FileType::CCI:
+            return std::make_unique<CCIWriter>(zar_reader, out_settings.compression_preset, out_settings.compression_level);
         default:
             throw XGDException(ErrCode::ISO_INVALID, HERE(), "Unknown file type");
     }
@@ -64,68 +99,80 @@ void ImageWriter::create_directory(const std::filesystem::path& dir_path)
 
 Xiso::DirectoryEntry::Header ImageWriter::get_directory_entry_header(const AvlTree::Node& node)
 {
-    Xiso::DirectoryEntry::Header dir_header;
-
-    dir_header.left_offset  = node.left_child ? static_cast<uint16_t>(node.left_child->offset / sizeof(uint32_t)) : 0;
-    dir_header.right_offset = node.right_child ? static_cast<uint16_t>(node.right_child->offset / sizeof(uint32_t)) : 0;
-    dir_header.start_sector = static_cast<uint32_t>(node.start_sector);
-    dir_header.file_size    = static_cast<uint32_t>(node.file_size + (node.subdirectory ? ((Xiso::SECTOR_SIZE - (node.file_size % Xiso::SECTOR_SIZE)) % Xiso::SECTOR_SIZE) : 0));
-    dir_header.attributes   = node.subdirectory ? Xiso::ATTRIBUTE_DIRECTORY : Xiso::ATTRIBUTE_FILE;
-    dir_header.name_length  = static_cast<uint8_t>(std::min(node.filename.size(), static_cast<size_t>(UINT8_MAX)));
-
-    EndianUtils::little_16(dir_header.left_offset);
-    EndianUtils::little_16(dir_header.right_offset);
-    EndianUtils::little_32(dir_header.start_sector);
-    EndianUtils::little_32(dir_header.file_size);
-
-    return dir_header;
+    return AvlIterator::directory_entry_header(node);
 }
 
-//Will write range of directory table entries, starting from start_index, to buffer, then pad to sector boundary. Returns number of processed entries.
 size_t ImageWriter::write_directory_to_buffer(const std::vector<AvlIterator::Entry>& avl_entries, const size_t start_index, std::vector<char>& entry_buffer)
 {
-    size_t entries_processed = 0;
+    return AvlIterator::write_directory_to_buffer(avl_entries, start_index, entry_buffer);
+}
 
-    for (uint64_t i = start_index; i < avl_entries.size(); ++i)
+uint32_t ImageWriter::num_sectors(const uint64_t num_bytes)
+{
+    return static_cast<uint32_t>(num_bytes / Xiso::SECTOR_SIZE) + ((num_bytes % Xiso::SECTOR_SIZE) ? 1 : 0);
+}
+
+std::unique_ptr<std::istream> ImageWriter::open_tree_file(const AvlTree::Node& node)
+{
+    if (zar_reader_)
     {
-        Xiso::DirectoryEntry::Header dir_header = get_directory_entry_header(*avl_entries[i].node);
+        return zar_reader_->open_file(node.path.generic_string());
+    }
 
-        uint64_t entry_len = sizeof(Xiso::DirectoryEntry::Header) + dir_header.name_length;
-        uint64_t buffer_pos = entry_buffer.size();
+    std::unique_ptr<std::ifstream> in_file = std::make_unique<std::ifstream>(node.path, std::ios::binary);
+    if (!in_file->is_open()) 
+    {
+        throw XGDException(ErrCode::FILE_OPEN, HERE(), node.path.string());
+    }
+    return in_file;
+}
 
-        entry_buffer.resize(buffer_pos + entry_len, Xiso::PAD_BYTE);
+const char* ImageWriter::read_sectors_scrubbed(ImageReader& image_reader, const uint32_t start_sector, const uint32_t count, const SectorSet* data_sectors, char* out_buffer)
+{
+    if (!data_sectors || data_sectors->contains_all(start_sector, start_sector + count)) 
+    {
+        ImageReader::Span span = image_reader.span_sectors(start_sector, count);
+        if (span) 
+        {
+            return span.data;
+        }
 
-        std::memcpy(entry_buffer.data() + buffer_pos, &dir_header, sizeof(Xiso::DirectoryEntry::Header));
-        std::memcpy(entry_buffer.data() + buffer_pos + sizeof(Xiso::DirectoryEntry::Header), avl_entries[i].node->filename.c_str(), dir_header.name_length);
+        image_reader.read_sectors(start_sector, count, out_buffer);
+        return out_buffer;
+    }
 
-        entries_processed++;
+    uint32_t current_sector = start_sector;
+    uint32_t end_sector = start_sector + count;
 
-        if (i == avl_entries.size() - 1 || 
-            !avl_entries[i + 1].directory_entry ||
-            avl_entries[i + 1].node->directory_start != avl_entries[i].node->directory_start) 
-        {
-            break;
-        }
+    while (current_sector < end_sector) 
+    {
+        bool is_data = data_sectors->contains(current_sector);
+        uint32_t run_end = data_sectors->run_end(current_sector, end_sector);
 
-        uint64_t padding_len = avl_entries[i + 1].node->offset - entry_buffer.size();
+        char* run_buffer = out_buffer + (static_cast<size_t>(current_sector - start_sector) * Xiso::SECTOR_SIZE);
 
-        if (padding_len > 0) 
+        if (is_data) 
         {
-            entry_buffer.resize(entry_buffer.size() + padding_len, Xiso::PAD_BYTE);
+            image_reader.read_sectors(current_sector, run_end - current_sector, run_buffer);
+        } 
+        else 
+        {
+            std::memset(run_buffer, 0x00, static_cast<size_t>(run_end - current_sector) * Xiso::SECTOR_SIZE);
         }
-    }
 
-    if (entry_buffer.size() % Xiso::SECTOR_SIZE) //Pad up to sector boundary
-    {
-        entry_buffer.resize(entry_buffer.size() + (Xiso::SECTOR_SIZE - (entry_buffer.size() % Xiso::SECTOR_SIZE)), Xiso::PAD_BYTE);
+        current_sector = run_end;
     }
 
-    return entries_processed;
+    return out_buffer;
 }
 
-uint32_t ImageWriter::num_sectors(const uint64_t num_bytes)
+std::unique_ptr<SectorPrefetcher> ImageWriter::prefetch_sectors_scrubbed(ImageReader& image_reader, const uint32_t start_sector, const uint32_t end_sector, const uint32_t batch_sectors, const SectorSet* data_sectors)
 {
-    return static_cast<uint32_t>(num_bytes / Xiso::SECTOR_SIZE) + ((num_bytes % Xiso::SECTOR_SIZE) ? 1 : 0);
+    return std::make_unique<SectorPrefetcher>(start_sector, end_sector, batch_sectors, prefetch_depth_, 
+        [this, &image_reader, data_sectors](uint32_t batch_start, uint32_t batch_count, char* out_buffer) 
+        {
+            return read_sectors_scrubbed(image_reader, batch_start, batch_count, data_sectors, out_buffer);
+        });
 }
 
 void ImageWriter::check_status_flags()
@@ -6,9 +6,12 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <istream>
 
 #include "ImageReader/ImageReader.h"
+#include "ImageReader/SectorPrefetcher/SectorPrefetcher.h"
 #include "TitleHelper/TitleHelper.h"
+#include "ZARExtractor/ZARReader.h"
 #include "InputHelper/Types.h"
 #include "AvlTree/AvlIterator.h"
 
@@ -19,6 +22,7 @@ public:
 
     static std::unique_ptr<ImageWriter> create_instance(std::shared_ptr<ImageReader> image_reader, TitleHelper& title_helper, const OutputSettings& out_settings); 
     static std::unique_ptr<ImageWriter> create_instance(const std::filesystem::path& in_dir_path, TitleHelper& title_helper, const OutputSettings& out_settings);
+    static std::unique_ptr<ImageWriter> create_instance(std::shared_ptr<ZARReader> zar_reader, TitleHelper& title_helper, const OutputSettings& out_settings);
 
     virtual std::vector<std::filesystem::path> convert(const std::filesystem::path& out_filepath) = 0;
 
@@ -26,15 +30,36 @@ public:
     void pause_processing() { write_pause_flag_ = true; }
     void resume_processing() { write_pause_flag_ = false; }
 
+    // Sectors read ahead of the output when converting an image, 0 disables read-ahead
+    void set_prefetch_depth(const size_t num_sectors) { prefetch_depth_ = num_sectors; }
+
 protected:
+    ImageWriter() = default;
+    explicit ImageWriter(std::shared_ptr<ZARReader> zar_reader) : zar_reader_(zar_reader) {}
+
     std::atomic<bool> write_cancel_flag_{false};
     std::atomic<bool> write_pause_flag_{false};
+    size_t prefetch_depth_{XGD::PREFETCH_SECTORS};
+
+    // Set when rebuilding from a ZAR archive, file nodes in the AvlTree then hold paths in the archive
+    std::shared_ptr<ZARReader> zar_reader_{nullptr};
 
     void check_status_flags();
     Xiso::DirectoryEntry::Header get_directory_entry_header(const AvlTree::Node& node);
     size_t write_directory_to_buffer(const std::vector<AvlIterator::Entry>& avl_entries, const size_t start_index, std::vector<char>& entry_buffer);
     void create_directory(const std::filesystem::path& dir_path);
     uint32_t num_sectors(const uint64_t num_bytes);
+
+    // Opens a file node of an AvlTree built from a directory or ZAR archive
+    std::unique_ptr<std::istream> open_tree_file(const AvlTree::Node& node);
+
+    /*  Reads count sectors for a no/partial scrub conversion, sectors missing from data_sectors are zeroed,
+        pass nullptr to keep every sector. Returns a pointer into the reader's memory if the batch 
+        can be used as is, otherwise the sectors are read into out_buffer and it's returned. */
+    const char* read_sectors_scrubbed(ImageReader& image_reader, const uint32_t start_sector, const uint32_t count, const SectorSet* data_sectors, char* out_buffer);
+
+    // Reads [start_sector, end_sector) with read_sectors_scrubbed in batches, ahead of the caller
+    std::unique_ptr<SectorPrefetcher> prefetch_sectors_scrubbed(ImageReader& image_reader, const uint32_t start_sector, const uint32_t end_sector, const uint32_t batch_sectors, const SectorSet* data_sectors);
 };
 
 #endif // _IMAGE_WRITER_H_
\ No newline at end of file
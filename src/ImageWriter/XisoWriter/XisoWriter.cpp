@@ -10,6 +10,9 @@ XisoWriter::XisoWriter(std::shared_ptr<ImageReader> image_reader, ScrubType scru
 XisoWriter::XisoWriter(const std::filesystem::path& in_dir_path, const bool split) 
     : split_(split), in_dir_path_(in_dir_path) {}
 
+XisoWriter::XisoWriter(std::shared_ptr<ZARReader> zar_reader, const bool split) 
+    : ImageWriter(zar_reader), split_(split) {}
+
 std::vector<std::filesystem::path> XisoWriter::convert(const std::filesystem::path& out_xiso_path) 
 {
     create_directory(out_xiso_path.parent_path());
@@ -24,6 +27,11 @@ std::vector<std::filesystem::path> XisoWriter::convert(const std::filesystem::pa
         AvlTree avl_tree(in_dir_path_.string(), in_dir_path_);
         return convert_to_xiso_from_avl(avl_tree, out_xiso_path);
     }
+    else if (zar_reader_) //Create ISO from ZAR archive
+    {
+        AvlTree avl_tree(zar_reader_->name(), *zar_reader_);
+        return convert_to_xiso_from_avl(avl_tree, out_xiso_path);
+    }
 
     if (!image_reader_) 
     {
@@ -38,12 +46,16 @@ std::vector<std::filesystem::path> XisoWriter::convert_to_xiso(const std::filesy
     ImageReader& image_reader = *image_reader_;
     uint32_t sector_offset = static_cast<uint32_t>(image_reader.image_offset() / Xiso::SECTOR_SIZE);
     uint32_t end_sector = image_reader.total_sectors();
-    const std::unordered_set<uint32_t>* data_sectors;
+    const SectorSet* data_sectors = nullptr;
 
     if (scrub) 
     {
-        data_sectors = &image_reader.data_sectors();
         end_sector = std::min(end_sector, image_reader.max_data_sector() + 1);
+
+        if (image_reader.platform() == Platform::OGX) 
+        {
+            data_sectors = &image_reader.data_sectors();
+        }
     }
 
     split::ofstream out_file(out_xiso_path, split_ ? Xiso::SPLIT_MARGIN : UINT64_MAX);
@@ -52,40 +64,32 @@ std::vector<std::filesystem::path> XisoWriter::convert_to_xiso(const std::filesy
         throw XGDException(ErrCode::FILE_OPEN, HERE(), out_xiso_path.string());
     }
 
-    std::vector<char> buffer(Xiso::SECTOR_SIZE);
+    const uint32_t batch_sectors = static_cast<uint32_t>(XGD::BULK_BUFFER_SIZE / Xiso::SECTOR_SIZE);
+
+    std::unique_ptr<SectorPrefetcher> prefetcher = prefetch_sectors_scrubbed(image_reader, sector_offset, end_sector, batch_sectors, data_sectors);
+    SectorPrefetcher::Batch batch;
 
     XGDLog() << "Writing XISO" << XGDLog::Endl;
 
-    for (uint32_t i = sector_offset; i < end_sector; i++) 
+    while (prefetcher->next(batch)) 
     {
-        bool write_sector = true;
-
-        if (scrub && image_reader.platform() == Platform::OGX) 
-        {
-            write_sector = data_sectors->find(i) != data_sectors->end();
-        }
-
-        if (write_sector) 
-        {
-            image_reader.read_sector(i, buffer.data());
-        } 
-        else 
-        {
-            std::memset(buffer.data(), 0x00, buffer.size());
-        }
-
-        out_file.write(buffer.data(), Xiso::SECTOR_SIZE);
+        out_file.write(batch.data, static_cast<size_t>(batch.count) * Xiso::SECTOR_SIZE);
         if (out_file.fail()) 
         {
             throw XGDException(ErrCode::FILE_WRITE, HERE(), "Failed to write sector to output file");
         }
 
-        XGDLog().print_progress(i - sector_offset, end_sector - sector_offset - 1);
+        XGDLog().print_progress(batch.start_sector + batch.count - sector_offset - 1, end_sector - sector_offset - 1);
 
         check_status_flags();
     }
 
     out_file.close();
+    if (out_file.fail()) 
+    {
+        throw XGDException(ErrCode::FILE_WRITE, HERE(), out_xiso_path.string());
+    }
+
     return out_file.paths();
 }
 
@@ -115,6 +119,11 @@ std::vector<std::filesystem::path> XisoWriter::convert_to_xiso_from_avl(AvlTree&
     pad_to_modulus(out_file, Xiso::FILE_MODULUS, 0x00);
 
     out_file.close();
+    if (out_file.fail()) 
+    {
+        throw XGDException(ErrCode::FILE_WRITE, HERE(), out_xiso_path.string());
+    }
+
     return out_file.paths();
 }
 
@@ -207,9 +216,13 @@ void XisoWriter::write_file_from_reader(AvlTree::Node* node, split::ofstream* ou
     {
         uint64_t read_size = std::min(bytes_remaining, XGD::BUFFER_SIZE);
 
-        image_reader_->read_bytes(read_position, read_size, buffer.data());
+        ImageReader::Span span = image_reader_->span_bytes(read_position, read_size);
+        if (!span) 
+        {
+            image_reader_->read_bytes(read_position, read_size, buffer.data());
+        }
 
-        out_file->write(buffer.data(), read_size);
+        out_file->write(span ? span.data : buffer.data(), read_size);
         if (out_file->fail()) 
         {
             throw XGDException(ErrCode::FILE_WRITE, HERE(), "Failed to write file data: " + node->filename);
@@ -244,11 +257,7 @@ void XisoWriter::write_file_from_directory(AvlTree::Node* node, split::ofstream*
         throw XGDException(ErrCode::FILE_SEEK, HERE(), "Failed to seek to file sector: " + node->filename);
     }
 
-    std::ifstream in_file(node->path, std::ios::binary);
-    if (!in_file.is_open()) 
-    {
-        throw XGDException(ErrCode::FILE_OPEN, HERE(), node->path.string());
-    }
+    std::unique_ptr<std::istream> in_file = open_tree_file(*node);
 
     uint64_t bytes_remaining = node->file_size;
     std::vector<char> buffer(XGD::BUFFER_SIZE, 0);
@@ -257,8 +266,8 @@ void XisoWriter::write_file_from_directory(AvlTree::Node* node, split::ofstream*
     {
         uint64_t read_size = std::min(bytes_remaining, XGD::BUFFER_SIZE);
 
-        in_file.read(buffer.data(), read_size);
-        if (in_file.fail()) 
+        in_file->read(buffer.data(), read_size);
+        if (in_file->fail()) 
         {
             throw XGDException(ErrCode::FILE_READ, HERE(), "Failed to read file data: " + node->path.string());
         }
@@ -276,8 +285,6 @@ void XisoWriter::write_file_from_directory(AvlTree::Node* node, split::ofstream*
         check_status_flags();
     }
 
-    in_file.close();
-
     if ((node->file_size + (node->start_sector * Xiso::SECTOR_SIZE)) != out_file->tellp()) 
     {
         throw XGDException(ErrCode::FILE_WRITE, HERE(), "File write size mismatch, possible overflow issue: " + node->filename);
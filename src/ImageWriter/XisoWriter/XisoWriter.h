@@ -16,6 +16,7 @@ class XisoWriter : public ImageWriter
 public:
     XisoWriter(std::shared_ptr<ImageReader> image_reader, ScrubType scrub_type, const bool split);
     XisoWriter(const std::filesystem::path& in_dir_path, const bool split);
+    XisoWriter(std::shared_ptr<ZARReader> zar_reader, const bool split);
     
     ~XisoWriter() override = default;
 
@@ -29,6 +29,9 @@ ZARWriter::ZARWriter(std::shared_ptr<ImageReader> image_reader)
 ZARWriter::ZARWriter(const std::filesystem::path& in_dir_path)
     : in_dir_path_(in_dir_path) {}
 
+ZARWriter::ZARWriter(std::shared_ptr<ZARReader> zar_reader)
+    : ImageWriter(zar_reader) {}
+
 std::vector<std::filesystem::path> ZARWriter::convert(const std::filesystem::path& out_zar_path) 
 {
     create_directory(out_zar_path.parent_path());
@@ -41,6 +44,10 @@ std::vector<std::filesystem::path> ZARWriter::convert(const std::filesystem::pat
     {
         convert_from_dir(out_zar_path);
     }
+    else if (zar_reader_)
+    {
+        convert_from_zar(out_zar_path);
+    }
     else 
     {
         throw XGDException(ErrCode::ISO_INVALID, HERE(), "No input source provided");
@@ -129,6 +136,77 @@ void ZARWriter::convert_from_dir(const std::filesystem::path& out_zar_path)
     z_writer.Finalize();
 }
 
+void ZARWriter::convert_from_zar(const std::filesystem::path& out_zar_path) 
+{
+    uint64_t prog_total = zar_reader_->total_file_bytes();
+    uint64_t prog_processed = 0;
+
+	PackContext pack_context;
+	pack_context.out_filepath = out_zar_path;
+
+    ZArchiveWriter z_writer(_pack_NewOutputFile, _pack_WriteOutputData, &pack_context);
+
+    XGDLog() << "Writing files to ZAR archive" << XGDLog::Endl;
+
+    write_zar_directory(z_writer, "", prog_processed, prog_total);
+
+    if (pack_context.has_error) 
+    {
+        throw XGDException(ErrCode::FILE_WRITE, HERE(), out_zar_path.string());
+    }
+
+    z_writer.Finalize();
+}
+
+void ZARWriter::write_zar_directory(ZArchiveWriter& z_writer, const std::string& dir_path, uint64_t& prog_processed, const uint64_t prog_total) 
+{
+    std::vector<char> buffer(XGD::BUFFER_SIZE);
+
+    for (const ZARReader::Entry& entry : zar_reader_->directory_entries(dir_path)) 
+    {
+        // Archive paths start with a '/', the writer takes them relative to the root
+        std::string entry_path = entry.path.substr(1);
+
+        if (entry.is_directory) 
+        {
+            if (!z_writer.MakeDir(entry_path.c_str(), false)) 
+            {
+                throw XGDException(ErrCode::FILE_WRITE, HERE(), entry_path);
+            }
+
+            write_zar_directory(z_writer, entry.path, prog_processed, prog_total);
+            continue;
+        }
+
+        if (!z_writer.StartNewFile(entry_path.c_str())) 
+        {
+            throw XGDException(ErrCode::FILE_WRITE, HERE(), entry_path);
+        }
+
+        std::unique_ptr<std::istream> in_file = zar_reader_->open_file(entry.path);
+        uint64_t bytes_remaining = entry.size;
+
+        while (bytes_remaining > 0) 
+        {
+            size_t read_size = static_cast<size_t>(std::min(static_cast<uint64_t>(buffer.size()), bytes_remaining));
+
+            in_file->read(buffer.data(), read_size);
+            if (in_file->fail()) 
+            {
+                throw XGDException(ErrCode::FILE_READ, HERE(), entry_path);
+            }
+
+            z_writer.AppendData(buffer.data(), read_size);
+
+            bytes_remaining -= read_size;
+
+            XGDLog().print_progress(prog_processed += read_size, prog_total);
+
+            check_status_flags();
+        }
+    }
+}
+
 void ZARWriter::convert_from_iso(const std::filesystem::path& out_zar_path) 
 {
     ImageReader& image_reader = *image_reader_;
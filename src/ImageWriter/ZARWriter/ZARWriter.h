@@ -16,6 +16,7 @@ class ZARWriter : public ImageWriter {
 public:
     ZARWriter(std::shared_ptr<ImageReader> image_reader);
     ZARWriter(const std::filesystem::path& in_dir_path);
+    ZARWriter(std::shared_ptr<ZARReader> zar_reader);
 
     ~ZARWriter() override = default;
 
@@ -27,6 +28,8 @@ private:
 
     void convert_from_iso(const std::filesystem::path& out_zar_path);
     void convert_from_dir(const std::filesystem::path& out_zar_path);
+    void convert_from_zar(const std::filesystem::path& out_zar_path);
+    void write_zar_directory(ZArchiveWriter& z_writer, const std::string& dir_path, uint64_t& prog_processed, const uint64_t prog_total);
 };
 
 #endif // _ZAR_WRITER_H_
\ No newline at end of file
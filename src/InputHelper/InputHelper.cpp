@@ -1,12 +1,14 @@
 #include "ImageReader/ImageReader.h"
+#include "ImageReader/GoDReader/GoDReader.h"
 #include "InputHelper/InputHelper.h"
 #include "Executable/AttachXbeTool.h"
 
 InputHelper::InputHelper(std::filesystem::path in_path, std::filesystem::path out_directory, OutputSettings output_settings)
     :   output_directory_(out_directory), 
-        output_settings_((output_settings.auto_format != AutoFormat::NONE) ? get_auto_output_settings(output_settings.auto_format) : output_settings)
+        output_settings_((output_settings.auto_format != AutoFormat::NONE) ? get_auto_output_settings(output_settings) : output_settings)
 {
     add_input(in_path);
+    init_metadata_cache();
 
     if (output_directory_.empty()) 
     {
@@ -18,13 +20,15 @@ InputHelper::InputHelper(std::filesystem::path in_path, std::filesystem::path ou
 
 InputHelper::InputHelper(std::vector<std::filesystem::path> in_paths, std::filesystem::path out_directory, OutputSettings output_settings)
     :   output_directory_(out_directory), 
-        output_settings_((output_settings.auto_format != AutoFormat::NONE) ? get_auto_output_settings(output_settings.auto_format) : output_settings)
+        output_settings_((output_settings.auto_format != AutoFormat::NONE) ? get_auto_output_settings(output_settings) : output_settings)
 {
     for (const auto& in_path : in_paths) 
     {
         add_input(in_path);
     }
 
+    init_metadata_cache();
+
     if (output_directory_.empty()) 
     {
         output_directory_ = in_paths.front().parent_path() / "XGDTool_Output";
@@ -110,6 +114,9 @@ void InputHelper::process_single(InputInfo input_info)
             case FileType::LIST:
                 list_files(input_info);
                 break;
+            case FileType::VERIFY:
+                verify_hashes(input_info);
+                break;
             default:
                 out_paths = create_image(input_info);
                 break;
@@ -136,30 +143,27 @@ void InputHelper::process_single(InputInfo input_info)
 
 std::vector<std::filesystem::path> InputHelper::create_image(InputInfo& input_info)
 {
-    std::filesystem::path temp_path;
-
-    if (input_info.file_type == FileType::ZAR) 
-    {
-        temp_path = extract_temp_zar(input_info.paths.front());
-        input_info.paths = { temp_path };
-        input_info.file_type = FileType::DIR;
-    }
-    else if (input_info.file_type == FileType::XBE)
+    if (input_info.file_type == FileType::XBE)
     {
         throw XGDException(ErrCode::ISO_INVALID, HERE(), "Cannot create image from XBE file");
     }
 
     std::unique_ptr<TitleHelper> title_helper;
     std::shared_ptr<ImageReader> image_reader;
+    std::shared_ptr<ZARReader> zar_reader;
 
     switch (input_info.file_type) 
     {
         case FileType::DIR:
             title_helper = std::make_unique<TitleHelper>(input_info.paths.front(), output_settings_.offline_mode);
             break;
+        case FileType::ZAR:
+            zar_reader = std::make_shared<ZARReader>(input_info.paths.front());
+            title_helper = std::make_unique<TitleHelper>(zar_reader, output_settings_.offline_mode);
+            break;
         default:
-            image_reader = ImageReader::create_instance(input_info.file_type, input_info.paths);
-            title_helper = std::make_unique<TitleHelper>(image_reader, output_settings_.offline_mode);
+            image_reader = create_image_reader(input_info);
+            title_helper = create_title_helper(image_reader);
             break;
     }
 
@@ -170,6 +174,9 @@ std::vector<std::filesystem::path> InputHelper::create_image(InputInfo& input_in
         case FileType::DIR:
             image_writer_ = ImageWriter::create_instance(input_info.paths.front(), *title_helper, output_settings_);
             break;
+        case FileType::ZAR:
+            image_writer_ = ImageWriter::create_instance(zar_reader, *title_helper, output_settings_);
+            break;
         default:
             image_writer_ = ImageWriter::create_instance(image_reader, *title_helper, output_settings_);
             break;
@@ -179,16 +186,9 @@ std::vector<std::filesystem::path> InputHelper::create_image(InputInfo& input_in
     
     reset_processor();
 
-    if (!temp_path.empty()) 
+    if (image_reader)
     {
-        try
-        {
-            std::filesystem::remove_all(temp_path);
-        }
-        catch (const std::filesystem::filesystem_error& e)
-        {
-            throw XGDException(ErrCode::FS_REMOVE, HERE(), e.what());
-        }
+        store_metadata(input_info, *image_reader, title_helper.get());
     }
 
     if (output_settings_.attach_xbe && title_helper->platform() == Platform::OGX)
@@ -218,16 +218,18 @@ std::vector<std::filesystem::path> InputHelper::create_dir(const InputInfo& inpu
         return { output_directory_ / input_info.paths.front().stem() };
     }
 
-    std::shared_ptr<ImageReader> image_reader = ImageReader::create_instance(input_info.file_type, input_info.paths);
+    std::shared_ptr<ImageReader> image_reader = create_image_reader(input_info);
 
-    TitleHelper title_helper(image_reader, output_settings_.offline_mode);
+    std::unique_ptr<TitleHelper> title_helper = create_title_helper(image_reader);
 
-    std::filesystem::path out_path = get_output_path(output_directory_, title_helper);
+    std::filesystem::path out_path = get_output_path(output_directory_, *title_helper);
 
-    image_extractor_ = std::make_unique<ImageExtractor>(*image_reader, title_helper, output_settings_.allowed_media_patch, output_settings_.rename_xbe);
+    image_extractor_ = std::make_unique<ImageExtractor>(*image_reader, *title_helper, output_settings_.allowed_media_patch, output_settings_.rename_xbe);
     image_extractor_->extract(out_path);
     reset_processor();
 
+    store_metadata(input_info, *image_reader, title_helper.get());
+
     return { out_path };
 }
 
@@ -238,30 +240,27 @@ std::vector<std::filesystem::path> InputHelper::create_attach_xbe(const InputInf
         throw XGDException(ErrCode::ISO_INVALID, HERE(), "Cannot create attach XBE from input type");
     }
 
-    std::shared_ptr<ImageReader> image_reader = ImageReader::create_instance(input_info.file_type, input_info.paths);
+    std::shared_ptr<ImageReader> image_reader = create_image_reader(input_info);
 
     if (image_reader->platform() != Platform::OGX)
     {
         throw XGDException(ErrCode::ISO_INVALID, HERE(), "Attach XBE can only be created for OGX images");
     }
 
-    TitleHelper title_helper(image_reader, output_settings_.offline_mode);
+    std::unique_ptr<TitleHelper> title_helper = create_title_helper(image_reader);
 
-    std::filesystem::path out_path = get_output_path(input_info.paths.front().parent_path(), title_helper);
+    std::filesystem::path out_path = get_output_path(input_info.paths.front().parent_path(), *title_helper);
 
-    AttachXbeTool attach_xbe_tool(title_helper); 
+    AttachXbeTool attach_xbe_tool(*title_helper); 
     attach_xbe_tool.generate_attach_xbe(out_path);
 
+    store_metadata(input_info, *image_reader, title_helper.get());
+
     return { out_path };
 }
 
 void InputHelper::list_files(const InputInfo& input_info) 
 {
-    if (input_info.file_type == FileType::DIR) 
-    {
-        throw XGDException(ErrCode::ISO_INVALID, HERE(), "Cannot list files from directory");
-    }
-
     XGDLog() << "Files in image:\n";
 
     if (input_info.file_type == FileType::ZAR) 
@@ -271,7 +270,10 @@ void InputHelper::list_files(const InputInfo& input_info)
         return;
     }
 
-    std::shared_ptr<ImageReader> image_reader = ImageReader::create_instance(input_info.file_type, input_info.paths);
+    // A directory's modification time doesn't cover the files in it, so its layout isn't cached
+    std::shared_ptr<ImageReader> image_reader = (input_info.file_type == FileType::DIR) 
+        ? ImageReader::create_instance(input_info.file_type, input_info.paths) 
+        : create_image_reader(input_info);
 
     for (const auto& entry : image_reader->directory_entries()) 
     {
@@ -282,25 +284,110 @@ void InputHelper::list_files(const InputInfo& input_info)
 
         XGDLog() << entry.path.string() << " (" << entry.header.file_size << " bytes)\n";
     }
+
+    if (input_info.file_type != FileType::DIR)
+    {
+        store_metadata(input_info, *image_reader, nullptr);
+    }
 }
 
-std::filesystem::path InputHelper::extract_temp_zar(const std::filesystem::path& in_path)
+void InputHelper::verify_hashes(const InputInfo& input_info) 
 {
-    std::filesystem::path temp_path = output_directory_ / "_temp";
+    if (input_info.file_type != FileType::GoD) 
+    {
+        throw XGDException(ErrCode::ISO_INVALID, HERE(), "Only GoD input can be verified");
+    }
 
-    try 
+    GoDReader god_reader(input_info.paths);
+
+    if (!god_reader.verify_hashtables()) 
     {
-        std::filesystem::create_directories(temp_path);
-    } 
-    catch (const std::filesystem::filesystem_error& e) 
+        throw XGDException(ErrCode::ISO_INVALID, HERE(), "Hash verification failed: " + input_info.paths.front().string());
+    }
+
+    XGDLog() << "Hash tables verified: " << input_info.paths.front().string() << "\n";
+}
+
+std::shared_ptr<ImageReader> InputHelper::create_image_reader(const InputInfo& input_info)
+{
+    std::shared_ptr<ImageReader> image_reader = ImageReader::create_instance(input_info.file_type, input_info.paths);
+
+    if (output_settings_.sector_cache_size >= 0)
     {
-        XGDException(ErrCode::FS_MKDIR, HERE(), e.what());
+        image_reader->set_sector_cache_size(static_cast<size_t>(output_settings_.sector_cache_size));
     }
-    
-    ZARExtractor zar_extractor(in_path);
-    zar_extractor.extract(temp_path);
 
-    return temp_path;
+    cached_record_ = MetadataCache::Record();
+
+    if (metadata_cache_)
+    {
+        switch (output_settings_.metadata_cache_mode)
+        {
+            case MetadataCacheMode::CLEAR:
+                metadata_cache_->remove(input_info.paths);
+                break;
+            case MetadataCacheMode::REFRESH:
+                break;
+            default:
+                if (metadata_cache_->load(input_info.paths, *image_reader, cached_record_))
+                {
+                    image_reader->load_metadata(cached_record_.image);
+                }
+                break;
+        }
+    }
+
+    return image_reader;
+}
+
+std::unique_ptr<TitleHelper> InputHelper::create_title_helper(std::shared_ptr<ImageReader> image_reader)
+{
+    // Offline names can always be reused, online ones only if they were found online
+    if (cached_record_.has_title_info && (cached_record_.title_info.online || output_settings_.offline_mode))
+    {
+        return std::make_unique<TitleHelper>(image_reader, output_settings_.offline_mode, cached_record_.title_info);
+    }
+    return std::make_unique<TitleHelper>(image_reader, output_settings_.offline_mode);
+}
+
+void InputHelper::init_metadata_cache()
+{
+    if (!output_settings_.metadata_cache_dir.empty())
+    {
+        metadata_cache_ = std::make_unique<MetadataCache>(output_settings_.metadata_cache_dir);
+    }
+}
+
+void InputHelper::store_metadata(const InputInfo& input_info, ImageReader& image_reader, TitleHelper* title_helper)
+{
+    if (!metadata_cache_ || output_settings_.metadata_cache_mode == MetadataCacheMode::CLEAR)
+    {
+        return;
+    }
+
+    MetadataCache::Record record;
+    record.image = image_reader.metadata();
+
+    if (title_helper)
+    {
+        record.has_title_info = true;
+        record.title_info = title_helper->title_info();
+    }
+    else if (cached_record_.has_title_info)
+    {
+        record.has_title_info = true;
+        record.title_info = cached_record_.title_info;
+    }
+
+    // The output was created already, a cache that can't be written shouldn't fail it
+    try
+    {
+        metadata_cache_->store(input_info.paths, image_reader, record);
+    }
+    catch (const std::exception& e)
+    {
+        XGDLog(Error) << "Warning: Failed to store metadata cache entry: " << e.what() << XGDLog::Endl;
+    }
 }
 
 void InputHelper::cancel_processing() 
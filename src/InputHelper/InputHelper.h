@@ -12,6 +12,7 @@
 #include "ZARExtractor/ZARExtractor.h"
 #include "ImageWriter/ImageWriter.h"
 #include "ImageExtractor/ImageExtractor.h"    
+#include "MetadataCache/MetadataCache.h"
 
 class InputHelper
 {
@@ -48,11 +49,18 @@ private:
     std::unique_ptr<ImageExtractor> image_extractor_{nullptr};
     std::unique_ptr<ZARExtractor> zar_extractor_{nullptr};
 
+    std::unique_ptr<MetadataCache> metadata_cache_{nullptr};
+    MetadataCache::Record cached_record_; // Entry loaded for the current input, if any
+
     std::vector<std::filesystem::path> create_image(InputInfo& input_info);
     std::vector<std::filesystem::path> create_dir(const InputInfo& input_info);
     std::vector<std::filesystem::path> create_attach_xbe(const InputInfo& input_info);
     void list_files(const InputInfo& input_info);
-    std::filesystem::path extract_temp_zar(const std::filesystem::path& in_path);
+    void verify_hashes(const InputInfo& input_info);
+    std::shared_ptr<ImageReader> create_image_reader(const InputInfo& input_info);
+    std::unique_ptr<TitleHelper> create_title_helper(std::shared_ptr<ImageReader> image_reader);
+    void init_metadata_cache();
+    void store_metadata(const InputInfo& input_info, ImageReader& image_reader, TitleHelper* title_helper);
     
     void add_input(const std::filesystem::path& in_path);
     bool has_extension(const std::filesystem::path& path, const std::string& extension);
@@ -64,7 +72,7 @@ private:
     FileType get_filetype(const std::filesystem::path& path);
 
     void remove_duplicate_infos(std::vector<InputInfo>& input_infos);
-    OutputSettings get_auto_output_settings(const AutoFormat auto_format);
+    OutputSettings get_auto_output_settings(const OutputSettings& user_settings);
     std::vector<std::filesystem::path> find_split_filepaths(const std::filesystem::path& in_filepath);
     std::filesystem::path get_output_path(const std::filesystem::path& out_directory, TitleHelper& title_helper);
     void reset_processor();
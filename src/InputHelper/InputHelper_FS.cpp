@@ -213,11 +213,21 @@ std::filesystem::path InputHelper::get_output_path(const std::filesystem::path&
     return out_path;
 }
 
-OutputSettings InputHelper::get_auto_output_settings(const AutoFormat auto_format) 
+OutputSettings InputHelper::get_auto_output_settings(const OutputSettings& user_settings) 
 {
     OutputSettings output_settings;
 
-    switch (auto_format) 
+    // Only the output format is automatic, keep how the user wants it processed
+    output_settings.auto_format = user_settings.auto_format;
+    output_settings.offline_mode = user_settings.offline_mode;
+    output_settings.sector_cache_size = user_settings.sector_cache_size;
+    output_settings.prefetch_sectors = user_settings.prefetch_sectors;
+    output_settings.metadata_cache_dir = user_settings.metadata_cache_dir;
+    output_settings.metadata_cache_mode = user_settings.metadata_cache_mode;
+    output_settings.compression_preset = user_settings.compression_preset;
+    output_settings.compression_level = user_settings.compression_level;
+
+    switch (user_settings.auto_format) 
     {
         case AutoFormat::OGXBOX:
             output_settings.file_type = FileType::DIR;
@@ -2,13 +2,16 @@
 #define _IHTYPES_H_
 
 #include <cstdint>
+#include <filesystem>
 
 #include "XGDLog.h"
 
 enum class Platform { UNKNOWN, OGX, X360 };
-enum class FileType { UNKNOWN, CCI, CSO, ISO, ZAR, DIR, GoD, XBE, LIST };
+enum class FileType { UNKNOWN, CCI, CSO, ISO, ZAR, DIR, GoD, XBE, LIST, VERIFY };
 enum class ScrubType { NONE, PARTIAL, FULL };
 enum class AutoFormat { NONE, OGXBOX, XBOX360, XEMU, XENIA };
+enum class MetadataCacheMode { USE, REFRESH, CLEAR };
+enum class CompressionPreset { FAST, HC, MAX, ADAPTIVE };
 
 struct OutputSettings 
 {
@@ -21,6 +24,12 @@ struct OutputSettings
     bool offline_mode{false};
     bool rename_xbe{false};
     bool xemu_paths{false};
+    int64_t sector_cache_size{-1}; // Sectors, -1 keeps the input reader's default
+    int64_t prefetch_sectors{-1}; // Sectors read ahead of the writer, -1 keeps the writer's default
+    std::filesystem::path metadata_cache_dir; // Empty disables the metadata cache
+    MetadataCacheMode metadata_cache_mode{MetadataCacheMode::USE};
+    CompressionPreset compression_preset{CompressionPreset::MAX}; // CSO/CCI only
+    int compression_level{-1}; // LZ4 HC level for CompressionPreset::HC, -1 uses LZ4's default
 };
 
 #endif // _IHTYPES_H_
\ No newline at end of file
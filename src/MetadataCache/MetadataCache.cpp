@@ -0,0 +1,403 @@
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include "XGD.h"
+#include "MetadataCache/MetadataCache.h"
+
+// Values are written in host byte order, the cache isn't meant to be moved between machines
+
+template <typename T>
+static void write_value(std::ofstream& out_file, const T& value)
+{
+    out_file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static void read_value(std::ifstream& in_file, T& value)
+{
+    in_file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (in_file.fail())
+    {
+        throw XGDException(ErrCode::FILE_READ, HERE(), "Truncated metadata cache entry");
+    }
+}
+
+static void write_string(std::ofstream& out_file, const std::string& string)
+{
+    write_value(out_file, static_cast<uint32_t>(string.size()));
+    out_file.write(string.data(), string.size());
+}
+
+static void read_string(std::ifstream& in_file, std::string& string)
+{
+    uint32_t size = 0;
+    read_value(in_file, size);
+
+    string.resize(size);
+    in_file.read(string.data(), size);
+    if (in_file.fail())
+    {
+        throw XGDException(ErrCode::FILE_READ, HERE(), "Truncated metadata cache entry");
+    }
+}
+
+MetadataCache::MetadataCache(const std::filesystem::path& cache_directory)
+    : cache_directory_(cache_directory)
+{
+    try
+    {
+        std::filesystem::create_directories(cache_directory_);
+    }
+    catch (const std::filesystem::filesystem_error& e)
+    {
+        throw XGDException(ErrCode::FS_MKDIR, HERE(), e.what());
+    }
+}
+
+std::filesystem::path MetadataCache::entry_path(const std::vector<std::filesystem::path>& image_paths)
+{
+    std::string key;
+    for (const auto& path : image_paths)
+    {
+        key += std::filesystem::absolute(path).lexically_normal().generic_u8string() + '\n';
+    }
+
+    uint8_t digest[HashUtils::SHA1_SIZE];
+    HashUtils::sha1(key.data(), key.size(), digest);
+
+    std::ostringstream name;
+    for (int i = 0; i < 8; ++i)
+    {
+        name << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+    }
+    name << ".xgdmeta";
+
+    return cache_directory_ / name.str();
+}
+
+std::vector<MetadataCache::SourceInfo> MetadataCache::source_infos(const std::vector<std::filesystem::path>& image_paths)
+{
+    std::vector<SourceInfo> infos;
+
+    for (const auto& path : image_paths)
+    {
+        SourceInfo info;
+        info.path = std::filesystem::absolute(path).lexically_normal().generic_u8string();
+
+        // A GoD image is a directory, its data files are what change
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+            {
+                if (entry.is_regular_file())
+                {
+                    info.size += entry.file_size();
+                    info.modified_time = std::max(info.modified_time, static_cast<int64_t>(entry.last_write_time().time_since_epoch().count()));
+                }
+            }
+        }
+        else
+        {
+            info.size = std::filesystem::file_size(path);
+            info.modified_time = static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+        }
+
+        infos.push_back(info);
+    }
+    return infos;
+}
+
+std::vector<uint8_t> MetadataCache::fingerprint(ImageReader& image_reader)
+{
+    // The XISO header holds the root directory location and the image timestamp
+    std::vector<char> header(Xiso::SECTOR_SIZE * 2);
+    image_reader.read_bytes(image_reader.image_offset() + Xiso::MAGIC_OFFSET, header.size(), header.data());
+
+    uint32_t total_sectors = image_reader.total_sectors();
+    header.insert(header.end(), reinterpret_cast<const char*>(&total_sectors), reinterpret_cast<const char*>(&total_sectors) + sizeof(total_sectors));
+
+    std::vector<uint8_t> digest(FINGERPRINT_SIZE);
+    HashUtils::sha1(header.data(), header.size(), digest.data());
+    return digest;
+}
+
+bool MetadataCache::load(const std::vector<std::filesystem::path>& image_paths, ImageReader& image_reader, Record& out_record)
+{
+    std::filesystem::path cache_path = entry_path(image_paths);
+
+    std::ifstream in_file(cache_path, std::ios::binary);
+    if (!in_file.is_open())
+    {
+        return false;
+    }
+
+    try
+    {
+        char magic[sizeof(MAGIC)];
+        uint32_t version = 0;
+
+        read_value(in_file, magic);
+        read_value(in_file, version);
+
+        if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION)
+        {
+            return false;
+        }
+
+        std::vector<SourceInfo> current_infos = source_infos(image_paths);
+        uint32_t num_sources = 0;
+        read_value(in_file, num_sources);
+
+        if (num_sources != current_infos.size())
+        {
+            return false;
+        }
+
+        for (const auto& current_info : current_infos)
+        {
+            SourceInfo cached_info;
+            read_string(in_file, cached_info.path);
+            read_value(in_file, cached_info.size);
+            read_value(in_file, cached_info.modified_time);
+
+            if (cached_info.path != current_info.path ||
+                cached_info.size != current_info.size ||
+                cached_info.modified_time != current_info.modified_time)
+            {
+                XGDLog(Debug) << "Metadata cache entry is stale: " << cache_path.string() << XGDLog::Endl;
+                return false;
+            }
+        }
+
+        std::vector<uint8_t> cached_fingerprint(FINGERPRINT_SIZE);
+        in_file.read(reinterpret_cast<char*>(cached_fingerprint.data()), cached_fingerprint.size());
+
+        if (in_file.fail() || cached_fingerprint != fingerprint(image_reader))
+        {
+            XGDLog(Debug) << "Metadata cache fingerprint mismatch: " << cache_path.string() << XGDLog::Endl;
+            return false;
+        }
+
+        read_record(in_file, out_record);
+    }
+    catch (const std::exception& e)
+    {
+        XGDLog(Debug) << "Failed to read metadata cache entry: " << e.what() << XGDLog::Endl;
+        return false;
+    }
+
+    XGDLog(Debug) << "Loaded metadata cache entry: " << cache_path.string() << XGDLog::Endl;
+    return true;
+}
+
+void MetadataCache::store(const std::vector<std::filesystem::path>& image_paths, ImageReader& image_reader, const Record& record)
+{
+    std::filesystem::path cache_path = entry_path(image_paths);
+    std::filesystem::path temp_path = cache_path;
+    temp_path += ".tmp";
+
+    std::ofstream out_file(temp_path, std::ios::binary);
+    if (!out_file.is_open())
+    {
+        throw XGDException(ErrCode::FILE_OPEN, HERE(), temp_path.string());
+    }
+
+    // Whatever goes wrong from here, the temporary file isn't left behind in the cache directory
+    try
+    {
+        out_file.write(MAGIC, sizeof(MAGIC));
+        write_value(out_file, VERSION);
+
+        std::vector<SourceInfo> infos = source_infos(image_paths);
+        write_value(out_file, static_cast<uint32_t>(infos.size()));
+
+        for (const auto& info : infos)
+        {
+            write_string(out_file, info.path);
+            write_value(out_file, info.size);
+            write_value(out_file, info.modified_time);
+        }
+
+        std::vector<uint8_t> image_fingerprint = fingerprint(image_reader);
+        out_file.write(reinterpret_cast<const char*>(image_fingerprint.data()), image_fingerprint.size());
+
+        write_record(out_file, record);
+
+        out_file.close();
+        if (out_file.fail())
+        {
+            throw XGDException(ErrCode::FILE_WRITE, HERE(), temp_path.string());
+        }
+
+        // Replace the old entry in one step so an interrupted run never leaves a half written one
+        try
+        {
+            std::filesystem::rename(temp_path, cache_path);
+        }
+        catch (const std::filesystem::filesystem_error& e)
+        {
+            throw XGDException(ErrCode::FS_RENAME, HERE(), e.what());
+        }
+    }
+    catch (...)
+    {
+        out_file.close();
+
+        std::error_code ec;
+        std::filesystem::remove(temp_path, ec);
+        throw;
+    }
+
+    XGDLog(Debug) << "Stored metadata cache entry: " << cache_path.string() << XGDLog::Endl;
+}
+
+void MetadataCache::remove(const std::vector<std::filesystem::path>& image_paths)
+{
+    std::filesystem::path cache_path = entry_path(image_paths);
+
+    try
+    {
+        if (std::filesystem::remove(cache_path))
+        {
+            XGDLog(Debug) << "Removed metadata cache entry: " << cache_path.string() << XGDLog::Endl;
+        }
+    }
+    catch (const std::filesystem::filesystem_error& e)
+    {
+        throw XGDException(ErrCode::FS_REMOVE, HERE(), e.what());
+    }
+}
+
+void MetadataCache::write_record(std::ofstream& out_file, const Record& record)
+{
+    write_value(out_file, static_cast<uint8_t>(record.image.has_directory_entries));
+
+    if (record.image.has_directory_entries)
+    {
+        write_value(out_file, static_cast<uint32_t>(record.image.directory_entries.size()));
+
+        for (const auto& entry : record.image.directory_entries)
+        {
+            write_value(out_file, entry.header);
+            write_string(out_file, entry.filename);
+            write_string(out_file, entry.path.generic_u8string());
+            write_value(out_file, entry.position);
+            write_value(out_file, entry.offset);
+        }
+    }
+
+    write_value(out_file, static_cast<uint8_t>(record.image.has_data_sectors));
+
+    if (record.image.has_data_sectors)
+    {
+        write_value(out_file, record.image.max_data_sector);
+        write_value(out_file, static_cast<uint32_t>(record.image.data_sectors.ranges().size()));
+
+        for (const auto& range : record.image.data_sectors)
+        {
+            write_value(out_file, range.start);
+            write_value(out_file, range.end);
+        }
+    }
+
+    write_value(out_file, static_cast<uint8_t>(record.has_title_info));
+
+    if (record.has_title_info)
+    {
+        const TitleHelper::TitleInfo& title_info = record.title_info;
+
+        write_value(out_file, static_cast<uint8_t>(title_info.online));
+        write_value(out_file, title_info.title_id);
+        write_value(out_file, static_cast<uint32_t>(title_info.platform));
+        write_string(out_file, title_info.title_name);
+        write_string(out_file, title_info.iso_name);
+        write_string(out_file, title_info.folder_name);
+        write_string(out_file, title_info.god_folder_name);
+        write_string(out_file, title_info.unique_name);
+        write_value(out_file, static_cast<uint32_t>(title_info.utf16_title_name.size()));
+        out_file.write(reinterpret_cast<const char*>(title_info.utf16_title_name.data()), title_info.utf16_title_name.size() * sizeof(char16_t));
+        write_value(out_file, title_info.xex_cert);
+        write_value(out_file, title_info.xbe_cert);
+    }
+}
+
+void MetadataCache::read_record(std::ifstream& in_file, Record& out_record)
+{
+    out_record = Record();
+
+    uint8_t flag = 0;
+    read_value(in_file, flag);
+    out_record.image.has_directory_entries = (flag != 0);
+
+    if (out_record.image.has_directory_entries)
+    {
+        uint32_t num_entries = 0;
+        read_value(in_file, num_entries);
+
+        for (uint32_t i = 0; i < num_entries; ++i)
+        {
+            Xiso::DirectoryEntry entry;
+            std::string path;
+
+            read_value(in_file, entry.header);
+            read_string(in_file, entry.filename);
+            read_string(in_file, path);
+            read_value(in_file, entry.position);
+            read_value(in_file, entry.offset);
+
+            entry.path = std::filesystem::u8path(path);
+            out_record.image.directory_entries.push_back(entry);
+        }
+    }
+
+    read_value(in_file, flag);
+    out_record.image.has_data_sectors = (flag != 0);
+
+    if (out_record.image.has_data_sectors)
+    {
+        uint32_t num_ranges = 0;
+        read_value(in_file, out_record.image.max_data_sector);
+        read_value(in_file, num_ranges);
+
+        for (uint32_t i = 0; i < num_ranges; ++i)
+        {
+            SectorSet::Range range;
+            read_value(in_file, range.start);
+            read_value(in_file, range.end);
+            out_record.image.data_sectors.insert(range.start, range.end);
+        }
+    }
+
+    read_value(in_file, flag);
+    out_record.has_title_info = (flag != 0);
+
+    if (out_record.has_title_info)
+    {
+        TitleHelper::TitleInfo& title_info = out_record.title_info;
+        uint32_t platform = 0;
+        uint32_t name_length = 0;
+
+        read_value(in_file, flag);
+        title_info.online = (flag != 0);
+        read_value(in_file, title_info.title_id);
+        read_value(in_file, platform);
+        title_info.platform = static_cast<Platform>(platform);
+        read_string(in_file, title_info.title_name);
+        read_string(in_file, title_info.iso_name);
+        read_string(in_file, title_info.folder_name);
+        read_string(in_file, title_info.god_folder_name);
+        read_string(in_file, title_info.unique_name);
+        read_value(in_file, name_length);
+
+        title_info.utf16_title_name.resize(name_length);
+        in_file.read(reinterpret_cast<char*>(title_info.utf16_title_name.data()), name_length * sizeof(char16_t));
+        if (in_file.fail())
+        {
+            throw XGDException(ErrCode::FILE_READ, HERE(), "Truncated metadata cache entry");
+        }
+
+        read_value(in_file, title_info.xex_cert);
+        read_value(in_file, title_info.xbe_cert);
+    }
+}
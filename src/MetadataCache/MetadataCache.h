@@ -0,0 +1,58 @@
+#ifndef _METADATA_CACHE_H_
+#define _METADATA_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+
+#include "Utils/HashUtils.h"
+#include "ImageReader/ImageReader.h"
+#include "TitleHelper/TitleHelper.h"
+
+/*  On-disk cache of parsed image metadata, one file per image in the cache directory.
+    Entries are keyed by the image's paths and only used if every part still has the same size
+    and modification time, and the image header hashes the same as when the entry was stored. */
+class MetadataCache
+{
+public:
+    struct Record
+    {
+        ImageReader::Metadata image;
+
+        bool has_title_info{false};
+        TitleHelper::TitleInfo title_info;
+    };
+
+    MetadataCache(const std::filesystem::path& cache_directory);
+    ~MetadataCache() = default;
+
+    // Returns false if there's no valid entry for the image
+    bool load(const std::vector<std::filesystem::path>& image_paths, ImageReader& image_reader, Record& out_record);
+    void store(const std::vector<std::filesystem::path>& image_paths, ImageReader& image_reader, const Record& record);
+    void remove(const std::vector<std::filesystem::path>& image_paths);
+
+private:
+    static constexpr char MAGIC[] = "XGDMETA";
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t FINGERPRINT_SIZE = HashUtils::SHA1_SIZE;
+
+    struct SourceInfo
+    {
+        std::string path;
+        uint64_t size{0};
+        int64_t modified_time{0};
+    };
+
+    std::filesystem::path cache_directory_;
+
+    std::filesystem::path entry_path(const std::vector<std::filesystem::path>& image_paths);
+    std::vector<SourceInfo> source_infos(const std::vector<std::filesystem::path>& image_paths);
+    std::vector<uint8_t> fingerprint(ImageReader& image_reader);
+
+    void write_record(std::ofstream& out_file, const Record& record);
+    void read_record(std::ifstream& in_file, Record& out_record);
+};
+
+#endif // _METADATA_CACHE_H_
@@ -0,0 +1,370 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#endif
+
+#include "SplitFStream/SplitFStream.h"
+
+split::async_ofstream::async_ofstream(const std::filesystem::path &_Path, std::ios_base::openmode _Mode) {
+    open_file(_Path, !(_Mode & std::ios::in));
+}
+
+split::async_ofstream::async_ofstream(async_ofstream&& other) noexcept
+    : handle(other.handle),
+      buffers(std::move(other.buffers)),
+      ring(std::move(other.ring)),
+      registered(other.registered),
+      current(other.current),
+      in_flight(other.in_flight),
+      position(other.position),
+      end_position(other.end_position),
+      failed(other.failed) {
+    other.handle = -1;
+    other.in_flight = 0;
+}
+
+split::async_ofstream& split::async_ofstream::operator=(async_ofstream&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle = other.handle;
+        buffers = std::move(other.buffers);
+        ring = std::move(other.ring);
+        registered = other.registered;
+        current = other.current;
+        in_flight = other.in_flight;
+        position = other.position;
+        end_position = other.end_position;
+        failed = other.failed;
+        other.handle = -1;
+        other.in_flight = 0;
+    }
+    return *this;
+}
+
+split::async_ofstream::~async_ofstream() {
+    close();
+}
+
+split::async_ofstream& split::async_ofstream::write(const char* _Str, std::streamsize _Count) {
+    if (handle == -1) {
+        failed = true;
+        return *this;
+    }
+
+    uint64_t bytes_left = static_cast<uint64_t>(_Count);
+
+    while (bytes_left > 0) {
+        Buffer& buffer = current_buffer();
+
+        if (buffer.size == 0) {
+            buffer.offset = position;
+        }
+
+        uint64_t to_copy = std::min(bytes_left, BUFFER_SIZE - buffer.size);
+        std::memcpy(buffer.data.get() + buffer.size, _Str, static_cast<size_t>(to_copy));
+
+        buffer.size += to_copy;
+        position += to_copy;
+        _Str += to_copy;
+        bytes_left -= to_copy;
+
+        if (buffer.size == BUFFER_SIZE) {
+            submit_current();
+        }
+    }
+
+    end_position = std::max(end_position, position);
+    return *this;
+}
+
+split::async_ofstream& split::async_ofstream::seekp(uint64_t _Off, std::ios_base::seekdir _Way) {
+    uint64_t new_pos = 0;
+    switch (_Way) {
+        case std::ios_base::beg:
+            new_pos = _Off;
+            break;
+        case std::ios_base::cur:
+            new_pos = position + _Off;
+            break;
+        case std::ios_base::end:
+            new_pos = end_position + _Off;
+            break;
+        default:
+            throw std::invalid_argument("Invalid seek direction");
+    }
+
+    // Buffers only ever hold one contiguous run, and nothing written from here may race a write in flight
+    if (new_pos != position) {
+        flush();
+        position = new_pos;
+    }
+    return *this;
+}
+
+uint64_t split::async_ofstream::tellp() const {
+    return position;
+}
+
+split::async_ofstream& split::async_ofstream::flush() {
+    if (buffers.empty()) {
+        return *this;
+    }
+
+    submit_current();
+
+    while (in_flight > 0) {
+        wait_one();
+    }
+    return *this;
+}
+
+bool split::async_ofstream::is_open() const {
+    return handle != -1;
+}
+
+bool split::async_ofstream::fail() const {
+    return failed;
+}
+
+bool split::async_ofstream::bad() const {
+    return failed;
+}
+
+bool split::async_ofstream::good() const {
+    return is_open() && !failed;
+}
+
+void split::async_ofstream::clear() {
+    failed = false;
+}
+
+void split::async_ofstream::close() {
+    if (handle == -1) {
+        return;
+    }
+
+    flush();
+
+    // Nothing is in flight after the flush, the ring can go before the buffers it has registered
+    ring.reset();
+    buffers.clear();
+    registered = false;
+    current = 0;
+
+    close_file();
+}
+
+split::async_ofstream::Buffer& split::async_ofstream::current_buffer() {
+    if (buffers.empty()) {
+        buffers.resize(NUM_BUFFERS);
+        for (Buffer& buffer : buffers) {
+            buffer.data.reset(new char[BUFFER_SIZE]);
+        }
+
+        ring = io_ring::create();
+        if (ring) {
+            std::vector<char*> data(NUM_BUFFERS);
+            for (uint32_t i = 0; i < NUM_BUFFERS; ++i) {
+                data[i] = buffers[i].data.get();
+            }
+            registered = ring->register_buffers(data.data(), NUM_BUFFERS, BUFFER_SIZE);
+        }
+    }
+
+    while (buffers[current].in_flight) {
+        wait_one();
+    }
+    return buffers[current];
+}
+
+void split::async_ofstream::submit_current() {
+    Buffer& buffer = buffers[current];
+    if (buffer.size == 0) {
+        return;
+    }
+
+    current = (current + 1) % NUM_BUFFERS;
+
+#ifdef __linux__
+    if (ring) {
+        uint8_t opcode = registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        uint32_t index = static_cast<uint32_t>(&buffer - buffers.data());
+
+        ring->submit(opcode, static_cast<int>(handle), buffer.offset, buffer.data.get(), static_cast<uint32_t>(buffer.size), index, static_cast<uint16_t>(index));
+        buffer.in_flight = true;
+        ++in_flight;
+
+        if (!ring->enter(1, 0)) {
+            retire_ring();
+        }
+        return;
+    }
+#endif
+
+    if (!write_at(buffer.offset, buffer.data.get(), buffer.size)) {
+        failed = true;
+    }
+    buffer.size = 0;
+}
+
+void split::async_ofstream::reap_completions() {
+    uint64_t tag = 0;
+    int32_t res = 0;
+
+    while (ring && ring->next_completion(tag, res)) {
+        Buffer& buffer = buffers[tag];
+
+        // Short writes are finished synchronously
+        if (res < 0) {
+            failed = true;
+        } else if (static_cast<uint64_t>(res) < buffer.size &&
+                   !write_at(buffer.offset + res, buffer.data.get() + res, buffer.size - res)) {
+            failed = true;
+        }
+
+        buffer.size = 0;
+        buffer.in_flight = false;
+        --in_flight;
+    }
+}
+
+void split::async_ofstream::wait_one() {
+    reap_completions();
+
+    if (in_flight == 0) {
+        return;
+    }
+    if (!ring->enter(0, 1)) {
+        retire_ring();
+        return;
+    }
+
+    reap_completions();
+}
+
+/*  io_uring_enter failed, the writes the kernel took are waited on, the ones it didn't
+    are taken back and written here, then the stream carries on with positional writes */
+void split::async_ofstream::retire_ring() {
+    uint32_t withdrawn = ring->withdraw();
+
+    while (in_flight > withdrawn) {
+        reap_completions();
+        if (in_flight > withdrawn) {
+            ring->wait_idle();
+        }
+    }
+
+    ring.reset();
+    registered = false;
+
+    for (Buffer& buffer : buffers) {
+        if (buffer.in_flight) {
+            if (!write_at(buffer.offset, buffer.data.get(), buffer.size)) {
+                failed = true;
+            }
+            buffer.size = 0;
+            buffer.in_flight = false;
+        }
+    }
+    in_flight = 0;
+}
+
+#ifdef _WIN32
+
+void split::async_ofstream::open_file(const std::filesystem::path &_Path, bool _Truncate) {
+    HANDLE file = CreateFileW(_Path.wstring().c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, _Truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return;
+    }
+
+    handle = reinterpret_cast<intptr_t>(file);
+    end_position = static_cast<uint64_t>(file_size.QuadPart);
+}
+
+bool split::async_ofstream::write_at(uint64_t _Off, const char* _Str, uint64_t _Count) {
+    HANDLE file = reinterpret_cast<HANDLE>(handle);
+    uint64_t bytes_written = 0;
+
+    while (bytes_written < _Count) {
+        OVERLAPPED overlapped = {};
+        uint64_t offset = _Off + bytes_written;
+        overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+        DWORD to_write = static_cast<DWORD>(std::min<uint64_t>(_Count - bytes_written, 0x40000000));
+        DWORD last_written = 0;
+
+        if (!WriteFile(file, _Str + bytes_written, to_write, &last_written, &overlapped) || last_written == 0) {
+            return false;
+        }
+        bytes_written += last_written;
+    }
+    return true;
+}
+
+void split::async_ofstream::close_file() {
+    CloseHandle(reinterpret_cast<HANDLE>(handle));
+    handle = -1;
+}
+
+#else
+
+void split::async_ofstream::open_file(const std::filesystem::path &_Path, bool _Truncate) {
+    int fd = ::open(_Path.c_str(), O_WRONLY | O_CREAT | (_Truncate ? O_TRUNC : 0), 0644);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) != 0) {
+        ::close(fd);
+        return;
+    }
+
+    handle = fd;
+    end_position = static_cast<uint64_t>(file_stat.st_size);
+}
+
+bool split::async_ofstream::write_at(uint64_t _Off, const char* _Str, uint64_t _Count) {
+    uint64_t bytes_written = 0;
+
+    while (bytes_written < _Count) {
+        ssize_t last_written = ::pwrite(static_cast<int>(handle), _Str + bytes_written, static_cast<size_t>(_Count - bytes_written), static_cast<off_t>(_Off + bytes_written));
+        if (last_written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (last_written <= 0) {
+            return false;
+        }
+        bytes_written += static_cast<uint64_t>(last_written);
+    }
+    return true;
+}
+
+void split::async_ofstream::close_file() {
+    ::close(static_cast<int>(handle));
+    handle = -1;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include <atomic>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "SplitFStream/SplitFStream.h"
+
+namespace split {
+    static std::atomic<bool> streaming_enabled{false};
+};
+
+void split::set_streaming_mode(bool _Enabled) {
+    streaming_enabled = _Enabled;
+}
+
+bool split::streaming_mode() {
+    return streaming_enabled;
+}
+
+split::cache_trimmer::cache_trimmer(const std::filesystem::path &_Path) {
+    open(_Path);
+}
+
+split::cache_trimmer::cache_trimmer(cache_trimmer&& other) noexcept
+    : fd(other.fd),
+      flushed(other.flushed),
+      dropped(other.dropped) {
+    other.fd = -1;
+}
+
+split::cache_trimmer& split::cache_trimmer::operator=(cache_trimmer&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd = other.fd;
+        flushed = other.flushed;
+        dropped = other.dropped;
+        other.fd = -1;
+    }
+    return *this;
+}
+
+split::cache_trimmer::~cache_trimmer() {
+    close();
+}
+
+#ifdef __linux__
+
+void split::cache_trimmer::open(const std::filesystem::path &_Path) {
+    close();
+
+    if (!streaming_mode()) {
+        return;
+    }
+
+    // A second descriptor for the same file, the page cache belongs to the file not the stream
+    fd = ::open(_Path.c_str(), O_RDONLY);
+    flushed = 0;
+    dropped = 0;
+}
+
+void split::cache_trimmer::trim(uint64_t _Written) {
+    if (fd < 0 || _Written < flushed + WINDOW_SIZE) {
+        return;
+    }
+
+    // Start writeback of the new window, then wait on the previous one and drop it
+    ::sync_file_range(fd, static_cast<off_t>(flushed), static_cast<off_t>(_Written - flushed), SYNC_FILE_RANGE_WRITE);
+
+    if (flushed > dropped) {
+        ::sync_file_range(fd, static_cast<off_t>(dropped), static_cast<off_t>(flushed - dropped), SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        ::posix_fadvise(fd, static_cast<off_t>(dropped), static_cast<off_t>(flushed - dropped), POSIX_FADV_DONTNEED);
+        dropped = flushed;
+    }
+
+    flushed = _Written;
+}
+
+void split::cache_trimmer::close() {
+    if (fd < 0) {
+        return;
+    }
+
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    fd = -1;
+}
+
+#else
+
+void split::cache_trimmer::open(const std::filesystem::path &_Path) {}
+
+void split::cache_trimmer::trim(uint64_t _Written) {}
+
+void split::cache_trimmer::close() {}
+
+#endif
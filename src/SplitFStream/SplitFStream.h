@@ -1,14 +1,161 @@
 #ifndef _SPLIT_FSTREAM_H_
 #define _SPLIT_FSTREAM_H_
 
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <filesystem>
 #include <vector>
+#include <memory>
 
 namespace split {
 
+/*  Streaming mode keeps large one-pass conversions from filling the page cache: 
+    input is read with sequential/drop-behind hints and written output is flushed 
+    and dropped from the cache as it goes. Off by default, no effect outside Linux. */
+void set_streaming_mode(bool _Enabled);
+bool streaming_mode();
+
+// Drops a sequentially written file from the page cache a window behind the write position in streaming mode
+class cache_trimmer {
+public:
+    static constexpr uint64_t WINDOW_SIZE = 0x1000000; // 16MB
+
+    cache_trimmer() {};
+    cache_trimmer(const std::filesystem::path &_Path);
+    cache_trimmer(cache_trimmer&& other) noexcept;
+    cache_trimmer& operator=(cache_trimmer&& other) noexcept;
+    ~cache_trimmer();
+
+    void open(const std::filesystem::path &_Path);
+    // _Written is how far into the file data has been written
+    void trim(uint64_t _Written);
+    // Call once the file's stream has been closed, flushes and drops whatever is left
+    void close();
+
+private:
+    int fd{-1};
+    uint64_t flushed{0};
+    uint64_t dropped{0};
+};
+
+/*  io_uring instance, one per thread used by pread_file to keep a large read's chunks in flight at once,
+    and one per async_ofstream for its buffer writes. Only available on Linux kernels with io_uring, 
+    thread_ring() returns nullptr otherwise and callers fall back to plain positional reads and writes. */
+class io_ring {
+public:
+    static constexpr uint32_t QUEUE_DEPTH = 16;
+    static constexpr uint64_t CHUNK_SIZE = 0x20000; // 128KB per request
+
+    ~io_ring();
+
+    io_ring(const io_ring&) = delete;
+    io_ring& operator=(const io_ring&) = delete;
+
+    static io_ring* thread_ring();
+    static void set_enabled(bool _Enabled);
+
+    // Reads _Count bytes at _Off from _Fd, returns the number of bytes read
+    uint64_t read(int _Fd, uint64_t _Off, char* _Str, uint64_t _Count);
+
+private:
+    friend class async_ofstream;
+
+    int ring_fd{-1};
+    bool retired{false}; // Set once io_uring_enter has failed, the thread falls back to pread
+
+    void* sq_ring{nullptr};
+    void* cq_ring{nullptr};
+    void* sqe_array{nullptr};
+    size_t sq_ring_size{0};
+    size_t cq_ring_size{0};
+    size_t sqe_array_size{0};
+
+    unsigned* sq_head{nullptr};
+    unsigned* sq_tail{nullptr};
+    unsigned* sq_mask{nullptr};
+    unsigned* sq_index{nullptr};
+    unsigned* cq_head{nullptr};
+    unsigned* cq_tail{nullptr};
+    unsigned* cq_mask{nullptr};
+    void* cqe_array{nullptr};
+
+    io_ring() {};
+    bool setup();
+    // A ring of its own, nullptr if io_uring is unavailable or disabled
+    static std::unique_ptr<io_ring> create();
+    // Registers _Count buffers of _Size bytes for fixed buffer writes
+    bool register_buffers(char* const* _Buffers, uint32_t _Count, uint64_t _Size);
+    void submit(uint8_t _Opcode, int _Fd, uint64_t _Off, char* _Str, uint32_t _Count, uint64_t _Tag, uint16_t _BufIndex = 0);
+    // False if io_uring_enter failed with anything other than an interruption
+    bool enter(uint32_t _Submit, uint32_t _Wait);
+    bool next_completion(uint64_t& _Tag, int32_t& _Res);
+    // Takes back entries the kernel hasn't consumed and retires the ring, returns how many
+    uint32_t withdraw();
+    // Waits a little for completions, polling if io_uring_enter fails
+    void wait_idle();
+};
+
+/*  Output file written through a ring of staging buffers. On Linux each full buffer goes out as an io_uring
+    write on the file's own ring, registered buffer writes when the kernel allows it, and the next buffers
+    are filled while it's in flight. Without io_uring each buffer is written with a positional write once full.
+    Has the members of std::ofstream the writers use, seeking elsewhere waits for every write in flight. 
+    Buffers are allocated on the first write and freed by close. */
+class async_ofstream {
+public:
+    static constexpr uint32_t NUM_BUFFERS = 8;
+    static constexpr uint64_t BUFFER_SIZE = 0x100000; // 1MB
+
+    async_ofstream() {};
+    // Truncates the file unless _Mode includes std::ios::in
+    async_ofstream(const std::filesystem::path &_Path, std::ios_base::openmode _Mode = std::ios::binary);
+    async_ofstream(async_ofstream&& other) noexcept;
+    async_ofstream& operator=(async_ofstream&& other) noexcept;
+    ~async_ofstream();
+
+    async_ofstream& write(const char* _Str, std::streamsize _Count);
+    async_ofstream& seekp(uint64_t _Off, std::ios_base::seekdir _Way);
+    uint64_t tellp() const;
+    // Writes out whatever is buffered and waits for every write in flight
+    async_ofstream& flush();
+
+    bool is_open() const;
+    bool fail() const;
+    bool bad() const;
+    bool good() const;
+    void clear();
+    void close();
+
+private:
+    struct Buffer {
+        std::unique_ptr<char[]> data;
+        uint64_t offset{0};
+        uint64_t size{0};
+        bool in_flight{false};
+    };
+
+    intptr_t handle{-1};
+    std::vector<Buffer> buffers;
+    std::unique_ptr<io_ring> ring; // After buffers so it's destroyed first, it may have them registered
+    bool registered{false};
+    uint32_t current{0};
+    uint32_t in_flight{0};
+    uint64_t position{0};
+    uint64_t end_position{0};
+    bool failed{false};
+
+    Buffer& current_buffer();
+    void submit_current();
+    void reap_completions();
+    void wait_one();
+    void retire_ring();
+
+    void open_file(const std::filesystem::path &_Path, bool _Truncate);
+    bool write_at(uint64_t _Off, const char* _Str, uint64_t _Count);
+    void close_file();
+};
+
 class PathsWrapper {
 public:
     explicit PathsWrapper(const std::vector<std::filesystem::path>& paths) : paths_(paths) {}
@@ -44,7 +191,8 @@ public:
     
 private:
     struct StreamInfo {
-        std::ofstream stream;
+        cache_trimmer cache; // Before stream so it's destroyed after the stream is closed
+        async_ofstream stream;
         std::filesystem::path path;
         unsigned int index;
     };
@@ -112,6 +260,77 @@ private:
     bool end_of_file{false};
 };
 
+// Read-only memory mapping of one or more split files, addressed as one contiguous image
+class mapped_file {
+public:
+    mapped_file() {};
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+    mapped_file(const std::vector<std::filesystem::path> &_Paths);
+    ~mapped_file();
+
+    uint64_t size() const;
+
+    // Pointer to _Count bytes at _Off, nullptr if the range is out of bounds or spans two parts
+    const char* data(uint64_t _Off, uint64_t _Count) const;
+    // Copies _Count bytes at _Off into _Str, returns the number of bytes copied
+    uint64_t read(uint64_t _Off, char* _Str, uint64_t _Count) const;
+
+    bool is_open() const;
+    void close();
+
+private:
+    struct MapInfo {
+        const char* data{nullptr};
+        uint64_t size{0};
+        uint64_t offset{0};
+        void* handle{nullptr};
+    };
+
+    std::vector<MapInfo> maps;
+    uint64_t total_size{0};
+    bool open{false};
+
+    void map_file(const std::filesystem::path &_Path, MapInfo &_Map);
+    void unmap_file(MapInfo &_Map);
+    size_t find_map(uint64_t _Off) const;
+};
+
+// Positional reads over one or more split files, safe to use from multiple threads at once
+class pread_file {
+public:
+    pread_file() {};
+    pread_file(pread_file&& other) noexcept;
+    pread_file& operator=(pread_file&& other) noexcept;
+    pread_file(const std::vector<std::filesystem::path> &_Paths);
+    ~pread_file();
+
+    uint64_t size() const;
+    size_t num_parts() const;
+    uint64_t part_size(size_t _Part) const;
+
+    // Reads _Count bytes at _Off with all parts addressed as one file, returns the number of bytes read
+    uint64_t read(uint64_t _Off, char* _Str, uint64_t _Count) const;
+    // Reads _Count bytes at _Off within a single part, returns the number of bytes read
+    uint64_t read_part(size_t _Part, uint64_t _Off, char* _Str, uint64_t _Count) const;
+
+    bool is_open() const;
+    void close();
+
+private:
+    struct FileInfo {
+        intptr_t handle{-1};
+        uint64_t size{0};
+        uint64_t offset{0};
+    };
+
+    std::vector<FileInfo> files;
+    uint64_t total_size{0};
+
+    void open_file(const std::filesystem::path &_Path, FileInfo &_File);
+    void close_file(FileInfo &_File);
+};
+
 }; // namespace split
 
 #endif // _SPLIT_FSTREAM_H_
\ No newline at end of file
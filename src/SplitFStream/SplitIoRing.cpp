@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <chrono>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "SplitFStream/SplitFStream.h"
+
+namespace split {
+    static std::atomic<bool> io_ring_enabled{true};
+};
+
+void split::io_ring::set_enabled(bool _Enabled) {
+    io_ring_enabled = _Enabled;
+}
+
+#ifdef __linux__
+
+split::io_ring* split::io_ring::thread_ring() {
+    thread_local std::unique_ptr<io_ring> ring;
+    thread_local bool failed = false;
+
+    if (!io_ring_enabled || failed) {
+        return nullptr;
+    }
+    if (ring && ring->retired) {
+        ring.reset();
+        failed = true;
+        return nullptr;
+    }
+    if (!ring) {
+        ring.reset(new io_ring());
+        if (!ring->setup()) {
+            // Kernel too old or io_uring blocked, don't retry on every read from this thread
+            ring.reset();
+            failed = true;
+        }
+    }
+    return ring.get();
+}
+
+std::unique_ptr<split::io_ring> split::io_ring::create() {
+    if (!io_ring_enabled) {
+        return nullptr;
+    }
+
+    std::unique_ptr<io_ring> ring(new io_ring());
+    if (!ring->setup()) {
+        return nullptr;
+    }
+    return ring;
+}
+
+split::io_ring::~io_ring() {
+    if (sqe_array) {
+        ::munmap(sqe_array, sqe_array_size);
+    }
+    if (cq_ring && cq_ring != sq_ring) {
+        ::munmap(cq_ring, cq_ring_size);
+    }
+    if (sq_ring) {
+        ::munmap(sq_ring, sq_ring_size);
+    }
+    if (ring_fd >= 0) {
+        ::close(ring_fd);
+    }
+}
+
+bool split::io_ring::setup() {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, QUEUE_DEPTH, &params));
+    if (ring_fd < 0) {
+        return false;
+    }
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    // Newer kernels map both rings with one call
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    }
+
+    sq_ring = ::mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+        sq_ring = nullptr;
+        return false;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        cq_ring = sq_ring;
+    } else {
+        cq_ring = ::mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED) {
+            cq_ring = nullptr;
+            return false;
+        }
+    }
+
+    sqe_array_size = params.sq_entries * sizeof(io_uring_sqe);
+    sqe_array = ::mmap(nullptr, sqe_array_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqe_array == MAP_FAILED) {
+        sqe_array = nullptr;
+        return false;
+    }
+
+    char* sq = static_cast<char*>(sq_ring);
+    char* cq = static_cast<char*>(cq_ring);
+
+    sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_index = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqe_array = cq + params.cq_off.cqes;
+
+    return true;
+}
+
+bool split::io_ring::register_buffers(char* const* _Buffers, uint32_t _Count, uint64_t _Size) {
+    std::vector<iovec> iovecs(_Count);
+
+    for (uint32_t i = 0; i < _Count; ++i) {
+        iovecs[i].iov_base = _Buffers[i];
+        iovecs[i].iov_len = static_cast<size_t>(_Size);
+    }
+
+    // Fails when the buffers don't fit under RLIMIT_MEMLOCK on older kernels, plain writes still work then
+    return ::syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS, iovecs.data(), _Count) == 0;
+}
+
+void split::io_ring::submit(uint8_t _Opcode, int _Fd, uint64_t _Off, char* _Str, uint32_t _Count, uint64_t _Tag, uint16_t _BufIndex) {
+    // Only one thread at a time produces entries, the kernel just has to see the entry before the new tail
+    unsigned tail = *sq_tail;
+    unsigned index = tail & *sq_mask;
+
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqe_array) + index;
+    std::memset(sqe, 0, sizeof(io_uring_sqe));
+    sqe->opcode = _Opcode;
+    sqe->fd = _Fd;
+    sqe->off = _Off;
+    sqe->addr = reinterpret_cast<uint64_t>(_Str);
+    sqe->len = _Count;
+    sqe->user_data = _Tag;
+
+    if (_Opcode == IORING_OP_READ_FIXED || _Opcode == IORING_OP_WRITE_FIXED) {
+        sqe->buf_index = _BufIndex;
+    }
+
+    sq_index[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+bool split::io_ring::enter(uint32_t _Submit, uint32_t _Wait) {
+    while (true) {
+        long result = ::syscall(__NR_io_uring_enter, ring_fd, _Submit, _Wait, _Wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        if (result >= 0) {
+            return true;
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            return false;
+        }
+    }
+}
+
+bool split::io_ring::next_completion(uint64_t& _Tag, int32_t& _Res) {
+    unsigned head = *cq_head;
+    if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+
+    const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(cqe_array) + (head & *cq_mask);
+    _Tag = cqe->user_data;
+    _Res = cqe->res;
+
+    __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t split::io_ring::withdraw() {
+    // Nothing else enters this ring, so entries the kernel hasn't consumed yet can be taken back by moving the tail
+    unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+    unsigned unsubmitted = *sq_tail - head;
+
+    __atomic_store_n(sq_tail, head, __ATOMIC_RELEASE);
+    retired = true;
+    return unsubmitted;
+}
+
+void split::io_ring::wait_idle() {
+    // Completions are posted whether or not io_uring_enter works, poll for them if it doesn't
+    if (!enter(0, 1)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+uint64_t split::io_ring::read(int _Fd, uint64_t _Off, char* _Str, uint64_t _Count) {
+    uint64_t num_chunks = (_Count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<uint64_t> chunk_read(num_chunks, 0);
+
+    uint64_t next_chunk = 0;
+    uint32_t in_flight = 0;
+
+    auto reap_completions = [&]() {
+        uint64_t tag = 0;
+        int32_t res = 0;
+
+        while (next_completion(tag, res)) {
+            chunk_read[tag] = (res > 0) ? static_cast<uint64_t>(res) : 0;
+            --in_flight;
+        }
+    };
+
+    while (next_chunk < num_chunks || in_flight > 0) {
+        uint32_t to_submit = 0;
+
+        while (next_chunk < num_chunks && in_flight < QUEUE_DEPTH) {
+            uint64_t chunk_offset = next_chunk * CHUNK_SIZE;
+            uint32_t chunk_size = static_cast<uint32_t>(std::min(CHUNK_SIZE, _Count - chunk_offset));
+
+            submit(IORING_OP_READ, _Fd, _Off + chunk_offset, _Str + chunk_offset, chunk_size, next_chunk);
+            ++next_chunk;
+            ++in_flight;
+            ++to_submit;
+        }
+
+        if (!enter(to_submit, 1)) {
+            /*  The kernel may still be reading into _Str, so every request it took has to complete before 
+                returning. The ring is retired and whatever it didn't read is finished with pread below. */
+            in_flight -= withdraw();
+
+            while (in_flight > 0) {
+                reap_completions();
+                if (in_flight > 0) {
+                    wait_idle();
+                }
+            }
+            break;
+        }
+
+        reap_completions();
+    }
+
+    uint64_t bytes_read = 0;
+
+    for (uint64_t i = 0; i < num_chunks; ++i) {
+        uint64_t chunk_offset = i * CHUNK_SIZE;
+        uint64_t chunk_size = std::min(CHUNK_SIZE, _Count - chunk_offset);
+
+        // Finish short or failed chunks synchronously, this also stops at end of file like pread does
+        while (chunk_read[i] < chunk_size) {
+            ssize_t last_read = ::pread(_Fd, _Str + chunk_offset + chunk_read[i], static_cast<size_t>(chunk_size - chunk_read[i]), static_cast<off_t>(_Off + chunk_offset + chunk_read[i]));
+            if (last_read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (last_read <= 0) {
+                break;
+            }
+            chunk_read[i] += static_cast<uint64_t>(last_read);
+        }
+
+        bytes_read += chunk_read[i];
+        if (chunk_read[i] != chunk_size) {
+            break;
+        }
+    }
+    return bytes_read;
+}
+
+#else
+
+split::io_ring* split::io_ring::thread_ring() {
+    return nullptr;
+}
+
+std::unique_ptr<split::io_ring> split::io_ring::create() {
+    return nullptr;
+}
+
+split::io_ring::~io_ring() {}
+
+bool split::io_ring::setup() {
+    return false;
+}
+
+bool split::io_ring::register_buffers(char* const* _Buffers, uint32_t _Count, uint64_t _Size) {
+    return false;
+}
+
+void split::io_ring::submit(uint8_t _Opcode, int _Fd, uint64_t _Off, char* _Str, uint32_t _Count, uint64_t _Tag, uint16_t _BufIndex) {}
+
+bool split::io_ring::enter(uint32_t _Submit, uint32_t _Wait) {
+    return false;
+}
+
+bool split::io_ring::next_completion(uint64_t& _Tag, int32_t& _Res) {
+    return false;
+}
+
+uint32_t split::io_ring::withdraw() {
+    return 0;
+}
+
+void split::io_ring::wait_idle() {}
+
+uint64_t split::io_ring::read(int _Fd, uint64_t _Off, char* _Str, uint64_t _Count) {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "SplitFStream/SplitFStream.h"
+
+split::mapped_file::mapped_file(mapped_file&& other) noexcept
+    : maps(std::move(other.maps)),
+      total_size(other.total_size),
+      open(other.open) {
+    other.maps.clear();
+    other.total_size = 0;
+    other.open = false;
+}
+
+split::mapped_file& split::mapped_file::operator=(mapped_file&& other) noexcept {
+    if (this != &other) {
+        close();
+        maps = std::move(other.maps);
+        total_size = other.total_size;
+        open = other.open;
+        other.maps.clear();
+        other.total_size = 0;
+        other.open = false;
+    }
+    return *this;
+}
+
+split::mapped_file::mapped_file(const std::vector<std::filesystem::path> &_Paths) {
+    maps.resize(_Paths.size());
+    try {
+        for (size_t i = 0; i < _Paths.size(); i++) {
+            map_file(_Paths[i], maps[i]);
+            maps[i].offset = total_size;
+            total_size += maps[i].size;
+        }
+    } catch (...) {
+        close();
+        throw;
+    }
+    open = !maps.empty();
+}
+
+split::mapped_file::~mapped_file() {
+    close();
+}
+
+uint64_t split::mapped_file::size() const {
+    return total_size;
+}
+
+bool split::mapped_file::is_open() const {
+    return open;
+}
+
+void split::mapped_file::close() {
+    for (auto& map : maps) {
+        unmap_file(map);
+    }
+    maps.clear();
+    total_size = 0;
+    open = false;
+}
+
+const char* split::mapped_file::data(uint64_t _Off, uint64_t _Count) const {
+    if (!open || _Off >= total_size || _Count > total_size - _Off) {
+        return nullptr;
+    }
+
+    const MapInfo& map = maps[find_map(_Off)];
+    if (_Off - map.offset + _Count > map.size) {
+        return nullptr;
+    }
+    return map.data + (_Off - map.offset);
+}
+
+uint64_t split::mapped_file::read(uint64_t _Off, char* _Str, uint64_t _Count) const {
+    if (!open || _Off >= total_size) {
+        return 0;
+    }
+
+    uint64_t bytes_read = 0;
+    _Count = std::min(_Count, total_size - _Off);
+
+    for (size_t i = find_map(_Off); i < maps.size() && bytes_read < _Count; i++) {
+        uint64_t map_position = (_Off + bytes_read) - maps[i].offset;
+        uint64_t copy_size = std::min(_Count - bytes_read, maps[i].size - map_position);
+        std::memcpy(_Str + bytes_read, maps[i].data + map_position, copy_size);
+        bytes_read += copy_size;
+    }
+    return bytes_read;
+}
+
+size_t split::mapped_file::find_map(uint64_t _Off) const {
+    auto it = std::upper_bound(maps.begin(), maps.end(), _Off,
+        [](uint64_t offset, const MapInfo& map) { return offset < map.offset; });
+    return static_cast<size_t>(std::distance(maps.begin(), it)) - 1;
+}
+
+#ifdef _WIN32
+
+void split::mapped_file::map_file(const std::filesystem::path &_Path, MapInfo &_Map) {
+    HANDLE file = CreateFileW(_Path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file: " + _Path.string());
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to get file size: " + _Path.string());
+    }
+
+    _Map.size = static_cast<uint64_t>(file_size.QuadPart);
+    if (_Map.size == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        throw std::runtime_error("Failed to map file: " + _Path.string());
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        throw std::runtime_error("Failed to map file: " + _Path.string());
+    }
+
+    _Map.data = static_cast<const char*>(view);
+    _Map.handle = mapping;
+}
+
+void split::mapped_file::unmap_file(MapInfo &_Map) {
+    if (_Map.data) {
+        UnmapViewOfFile(_Map.data);
+    }
+    if (_Map.handle) {
+        CloseHandle(static_cast<HANDLE>(_Map.handle));
+    }
+    _Map = MapInfo();
+}
+
+#else
+
+void split::mapped_file::map_file(const std::filesystem::path &_Path, MapInfo &_Map) {
+    int fd = ::open(_Path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + _Path.string());
+    }
+
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to get file size: " + _Path.string());
+    }
+
+    _Map.size = static_cast<uint64_t>(file_stat.st_size);
+    if (_Map.size == 0) {
+        ::close(fd);
+        return;
+    }
+
+    void* view = ::mmap(nullptr, _Map.size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        throw std::runtime_error("Failed to map file: " + _Path.string());
+    }
+
+    _Map.data = static_cast<const char*>(view);
+}
+
+void split::mapped_file::unmap_file(MapInfo &_Map) {
+    if (_Map.data) {
+        ::munmap(const_cast<char*>(_Map.data), _Map.size);
+    }
+    _Map = MapInfo();
+}
+
+#endif
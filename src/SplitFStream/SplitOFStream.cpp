@@ -85,18 +85,22 @@ split::ofstream& split::ofstream::seekp(uint64_t _Off, std::ios_base::seekdir _W
 
 split::ofstream& split::ofstream::write(const char* _Str, std::streamsize _Count) {
     while (_Count > 0) {
-        uint64_t bytes_left = max_filesize - outfiles[current_stream].stream.tellp();
+        uint64_t pos_in_file = current_position - max_filesize * current_stream;
+        uint64_t bytes_left = max_filesize - pos_in_file;
 
-        if (bytes_left <= 0) {
+        if (bytes_left == 0) {
             current_stream++;
             if (current_stream >= outfiles.size()) {
                 open_new_stream();
+            } else {
+                outfiles[current_stream].stream.seekp(0, std::ios::beg);
             }
             continue;
         }
 
         std::streamsize to_write = std::min(static_cast<uint64_t>(_Count), bytes_left);
         outfiles[current_stream].stream.write(_Str, to_write);
+        outfiles[current_stream].cache.trim(pos_in_file + to_write);
         _Str += to_write;
         _Count -= to_write;
         current_position += to_write;
@@ -137,6 +141,7 @@ void split::ofstream::clear() {
 void split::ofstream::close() {
     for (auto& file : outfiles) {
         file.stream.close();
+        file.cache.close();
     }
     rename_output_files();
 }
@@ -162,7 +167,8 @@ std::filesystem::path split::ofstream::get_next_filepath() {
 
 void split::ofstream::open_new_stream() {
     std::filesystem::path filepath = get_next_filepath();
-    outfiles.push_back({ std::ofstream(filepath, std::ios::binary), filepath, current_stream });
+    outfiles.push_back({ cache_trimmer(), async_ofstream(filepath, std::ios::binary), filepath, current_stream });
+    outfiles.back().cache.open(filepath);
 }
 
 void split::ofstream::rename_output_files() {
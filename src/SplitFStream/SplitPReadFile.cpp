@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "SplitFStream/SplitFStream.h"
+
+split::pread_file::pread_file(pread_file&& other) noexcept
+    : files(std::move(other.files)),
+      total_size(other.total_size) {
+    other.files.clear();
+    other.total_size = 0;
+}
+
+split::pread_file& split::pread_file::operator=(pread_file&& other) noexcept {
+    if (this != &other) {
+        close();
+        files = std::move(other.files);
+        total_size = other.total_size;
+        other.files.clear();
+        other.total_size = 0;
+    }
+    return *this;
+}
+
+split::pread_file::pread_file(const std::vector<std::filesystem::path> &_Paths) {
+    files.resize(_Paths.size());
+    try {
+        for (size_t i = 0; i < _Paths.size(); i++) {
+            open_file(_Paths[i], files[i]);
+            files[i].offset = total_size;
+            total_size += files[i].size;
+        }
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+split::pread_file::~pread_file() {
+    close();
+}
+
+uint64_t split::pread_file::size() const {
+    return total_size;
+}
+
+size_t split::pread_file::num_parts() const {
+    return files.size();
+}
+
+uint64_t split::pread_file::part_size(size_t _Part) const {
+    return (_Part < files.size()) ? files[_Part].size : 0;
+}
+
+bool split::pread_file::is_open() const {
+    return !files.empty();
+}
+
+void split::pread_file::close() {
+    for (auto& file : files) {
+        close_file(file);
+    }
+    files.clear();
+    total_size = 0;
+}
+
+uint64_t split::pread_file::read(uint64_t _Off, char* _Str, uint64_t _Count) const {
+    if (files.empty() || _Off >= total_size) {
+        return 0;
+    }
+
+    auto it = std::upper_bound(files.begin(), files.end(), _Off,
+        [](uint64_t offset, const FileInfo& file) { return offset < file.offset; });
+    size_t part = static_cast<size_t>(std::distance(files.begin(), it)) - 1;
+
+    uint64_t bytes_read = 0;
+    _Count = std::min(_Count, total_size - _Off);
+
+    for (; part < files.size() && bytes_read < _Count; part++) {
+        uint64_t part_position = (_Off + bytes_read) - files[part].offset;
+        uint64_t to_read = std::min(_Count - bytes_read, files[part].size - part_position);
+        uint64_t part_read = read_part(part, part_position, _Str + bytes_read, to_read);
+
+        bytes_read += part_read;
+        if (part_read != to_read) {
+            break;
+        }
+    }
+    return bytes_read;
+}
+
+#ifdef _WIN32
+
+uint64_t split::pread_file::read_part(size_t _Part, uint64_t _Off, char* _Str, uint64_t _Count) const {
+    if (_Part >= files.size()) {
+        return 0;
+    }
+
+    HANDLE handle = reinterpret_cast<HANDLE>(files[_Part].handle);
+    uint64_t bytes_read = 0;
+
+    while (bytes_read < _Count) {
+        OVERLAPPED overlapped = {};
+        uint64_t position = _Off + bytes_read;
+        overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+        DWORD to_read = static_cast<DWORD>(std::min<uint64_t>(_Count - bytes_read, 0x40000000));
+        DWORD last_read = 0;
+
+        if (!ReadFile(handle, _Str + bytes_read, to_read, &last_read, &overlapped) || last_read == 0) {
+            break;
+        }
+        bytes_read += last_read;
+    }
+    return bytes_read;
+}
+
+void split::pread_file::open_file(const std::filesystem::path &_Path, FileInfo &_File) {
+    HANDLE handle = CreateFileW(_Path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file: " + _Path.string());
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(handle, &file_size)) {
+        CloseHandle(handle);
+        throw std::runtime_error("Failed to get file size: " + _Path.string());
+    }
+
+    _File.handle = reinterpret_cast<intptr_t>(handle);
+    _File.size = static_cast<uint64_t>(file_size.QuadPart);
+}
+
+void split::pread_file::close_file(FileInfo &_File) {
+    if (_File.handle != -1) {
+        CloseHandle(reinterpret_cast<HANDLE>(_File.handle));
+    }
+    _File = FileInfo();
+}
+
+#else
+
+uint64_t split::pread_file::read_part(size_t _Part, uint64_t _Off, char* _Str, uint64_t _Count) const {
+    if (_Part >= files.size()) {
+        return 0;
+    }
+
+    int fd = static_cast<int>(files[_Part].handle);
+    uint64_t bytes_read = 0;
+
+    // Large reads go out as several requests at once, small ones aren't worth the round trip
+    io_ring* ring = (_Count > io_ring::CHUNK_SIZE) ? io_ring::thread_ring() : nullptr;
+
+    if (ring) {
+        bytes_read = ring->read(fd, _Off, _Str, _Count);
+    } else {
+        while (bytes_read < _Count) {
+            ssize_t last_read = ::pread(fd, _Str + bytes_read, static_cast<size_t>(_Count - bytes_read), static_cast<off_t>(_Off + bytes_read));
+            if (last_read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (last_read <= 0) {
+                break;
+            }
+            bytes_read += static_cast<uint64_t>(last_read);
+        }
+    }
+
+#ifdef __linux__
+    /*  Input is read once front to back in streaming mode, don't keep it cached. Small reads are headers
+        and directory tables that are likely read again, and aren't worth a syscall each */
+    if (streaming_mode() && _Count >= io_ring::CHUNK_SIZE && bytes_read > 0) {
+        ::posix_fadvise(fd, static_cast<off_t>(_Off), static_cast<off_t>(bytes_read), POSIX_FADV_DONTNEED);
+    }
+#endif
+
+    return bytes_read;
+}
+
+void split::pread_file::open_file(const std::filesystem::path &_Path, FileInfo &_File) {
+    int fd = ::open(_Path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + _Path.string());
+    }
+
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to get file size: " + _Path.string());
+    }
+
+    _File.handle = fd;
+    _File.size = static_cast<uint64_t>(file_stat.st_size);
+
+#ifdef __linux__
+    if (streaming_mode()) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+}
+
+void split::pread_file::close_file(FileInfo &_File) {
+    if (_File.handle != -1) {
+        ::close(static_cast<int>(_File.handle));
+    }
+    _File = FileInfo();
+}
+
+#endif
@@ -18,12 +18,36 @@ TitleHelper::TitleHelper(std::shared_ptr<ImageReader> image_reader, bool offline
     initialize();
 }
 
+TitleHelper::TitleHelper(std::shared_ptr<ImageReader> image_reader, bool offline_mode, const TitleInfo& title_info) 
+    : offline_mode_(offline_mode), image_reader_(image_reader) 
+{
+    online_ = title_info.online;
+    title_id_ = title_info.title_id;
+    platform_ = title_info.platform;
+    title_name_ = title_info.title_name;
+    iso_name_ = title_info.iso_name;
+    folder_name_ = title_info.folder_name;
+    god_folder_name_ = title_info.god_folder_name;
+    unique_name_ = title_info.unique_name;
+    utf16_title_name_ = title_info.utf16_title_name;
+    xex_cert_ = title_info.xex_cert;
+    xbe_cert_ = title_info.xbe_cert;
+
+    XGDLog(Debug) << "Title information restored for: " << title_name_ << XGDLog::Endl;
+}
+
 TitleHelper::TitleHelper(const std::filesystem::path& in_dir_path, bool offline_mode) 
     : offline_mode_(offline_mode), in_dir_path_(in_dir_path) 
 {
     initialize();
 }
 
+TitleHelper::TitleHelper(std::shared_ptr<ZARReader> zar_reader, bool offline_mode) 
+    : offline_mode_(offline_mode), zar_reader_(zar_reader) 
+{
+    initialize();
+}
+
 void TitleHelper::initialize() 
 {
     std::unique_ptr<ExeTool> exe_tool{nullptr};
@@ -32,6 +56,18 @@ void TitleHelper::initialize()
     {
         exe_tool = std::make_unique<ExeTool>(*image_reader_, image_reader_->executable_entry().path); 
     }
+    else if (zar_reader_)
+    {
+        for (const auto& entry : zar_reader_->directory_entries("")) 
+        {
+            if (!entry.is_directory && (StringUtils::case_insensitive_search(entry.name, "default.xex") || 
+                                        StringUtils::case_insensitive_search(entry.name, "default.xbe"))) 
+            {
+                exe_tool = std::make_unique<ExeTool>(*zar_reader_, entry.path);
+                break;
+            }
+        }
+    }
     else
     {
         for (const auto& entry : std::filesystem::directory_iterator(in_dir_path_)) 
@@ -81,6 +117,8 @@ void TitleHelper::initialize()
         initialize_offline(*exe_tool);
     }
 
+    online_ = initialized;
+
     XGDLog(Debug) << "Title information retrieved for: " << title_name_ << XGDLog::Endl;
 }
 
@@ -90,6 +128,10 @@ void TitleHelper::initialize_offline(ExeTool& exe_tool)
     {
         title_name_ = image_reader_->name();
     }
+    else if (zar_reader_) 
+    {
+        title_name_ = zar_reader_->name();
+    }
     else 
     {
         title_name_ = in_dir_path_.filename().string();
@@ -274,6 +316,23 @@ bool TitleHelper::set_x360_titles_online(ExeTool& exe_tool)
     return true;
 }
 
+TitleHelper::TitleInfo TitleHelper::title_info() 
+{
+    TitleInfo title_info;
+    title_info.online = online_;
+    title_info.title_id = title_id_;
+    title_info.platform = platform_;
+    title_info.title_name = title_name_;
+    title_info.iso_name = iso_name_;
+    title_info.folder_name = folder_name_;
+    title_info.god_folder_name = god_folder_name_;
+    title_info.unique_name = unique_name_;
+    title_info.utf16_title_name = utf16_title_name_;
+    title_info.xex_cert = xex_cert_;
+    title_info.xbe_cert = xbe_cert_;
+    return title_info;
+}
+
 const std::vector<char>& TitleHelper::title_icon() {
     if (title_icon_data_.empty() && !offline_mode_ && internet_connected()) 
     {
@@ -9,6 +9,7 @@
 
 #include "XGD.h"
 #include "ImageReader/ImageReader.h"
+#include "ZARExtractor/ZARReader.h"
 #include "InputHelper/Types.h"
 #include "Executable/ExeTool.h"
 #include "Formats/Xex.h"
@@ -17,8 +18,26 @@
 class TitleHelper 
 {
 public:
+    // Everything initialize() works out, so it can be cached and restored without the lookup
+    struct TitleInfo
+    {
+        bool online{false}; // Names came from an online database
+        uint32_t title_id{0};
+        Platform platform{Platform::UNKNOWN};
+        std::string title_name;
+        std::string iso_name;
+        std::string folder_name;
+        std::string god_folder_name;
+        std::string unique_name;
+        std::vector<char16_t> utf16_title_name;
+        Xex::ExecutionInfo xex_cert{};
+        Xbe::Cert xbe_cert{};
+    };
+
     TitleHelper(std::shared_ptr<ImageReader> image_reader, bool offline_mode);
+    TitleHelper(std::shared_ptr<ImageReader> image_reader, bool offline_mode, const TitleInfo& title_info);
     TitleHelper(const std::filesystem::path& in_dir_path, bool offline_mode);
+    TitleHelper(std::shared_ptr<ZARReader> zar_reader, bool offline_mode);
 
     ~TitleHelper() = default;
 
@@ -33,14 +52,18 @@ public:
     const Xex::ExecutionInfo& xex_cert() { return xex_cert_; };
     const Xbe::Cert& xbe_cert() { return xbe_cert_; };
 
+    TitleInfo title_info();
+
 private:
     const std::string REPACK_LIST_URL = "https://raw.githubusercontent.com/Team-Resurgent/Repackinator/main/RepackList.json";
     const std::string UNITY_URL_PREFIX = "http://xboxunity.net/Resources/Lib/TitleUpdateInfo.php?titleid=";
 
     bool offline_mode_{false};
+    bool online_{false};
 
     std::filesystem::path in_dir_path_; 
     std::shared_ptr<ImageReader> image_reader_{nullptr};
+    std::shared_ptr<ZARReader> zar_reader_{nullptr};
 
     uint32_t title_id_{0};
 
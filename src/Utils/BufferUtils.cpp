@@ -0,0 +1,63 @@
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define BUFFER_UTILS_SSE2
+#endif
+
+#include "Utils/BufferUtils.h"
+
+namespace BufferUtils {
+
+bool is_zero(const char* data, const size_t size) 
+{
+    return is_filled(data, size, 0x00);
+}
+
+bool is_filled(const char* data, const size_t size, const uint8_t value) 
+{
+    size_t position = 0;
+
+#ifdef BUFFER_UTILS_SSE2
+    const __m128i pattern = _mm_set1_epi8(static_cast<char>(value));
+
+    // 64 bytes per iteration, any byte that differs from value leaves a bit set after the xor
+    for (; position + 64 <= size; position += 64) 
+    {
+        __m128i block = _mm_or_si128(
+            _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position)), pattern), 
+                         _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position + 16)), pattern)),
+            _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position + 32)), pattern), 
+                         _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position + 48)), pattern)));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128())) != 0xFFFF) 
+        {
+            return false;
+        }
+    }
+#endif
+
+    const uint64_t word_pattern = 0x0101010101010101ULL * value;
+
+    for (; position + sizeof(uint64_t) <= size; position += sizeof(uint64_t)) 
+    {
+        uint64_t word;
+        std::memcpy(&word, data + position, sizeof(uint64_t));
+        if (word != word_pattern) 
+        {
+            return false;
+        }
+    }
+
+    for (; position < size; ++position) 
+    {
+        if (static_cast<uint8_t>(data[position]) != value) 
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}; // namespace BufferUtils
@@ -0,0 +1,12 @@
+#ifndef _BUFFER_UTILS_H_
+#define _BUFFER_UTILS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BufferUtils {
+    bool is_zero(const char* data, const size_t size); // Uses SSE2 where available
+    bool is_filled(const char* data, const size_t size, const uint8_t value); // True if every byte is value, uses SSE2 where available
+};
+
+#endif // _BUFFER_UTILS_H_
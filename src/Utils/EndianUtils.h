@@ -7,7 +7,11 @@ namespace EndianUtils {
 
     constexpr bool is_big_endian() 
     {
-        return ((1 << 24) & 0x01000000) != 0;
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+        return __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+#else
+        return false; // MSVC only targets little endian
+#endif
     }
 
     void big_16(uint16_t &value);    // Only swaps if sys is little endian
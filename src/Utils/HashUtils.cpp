@@ -0,0 +1,68 @@
+#include <memory>
+
+#include <openssl/evp.h>
+
+#include "XGD.h"
+#include "Utils/HashUtils.h"
+
+namespace HashUtils {
+
+namespace 
+{
+    struct MDContextDeleter 
+    {
+        void operator()(EVP_MD_CTX* context) const { EVP_MD_CTX_free(context); }
+    };
+
+    // Fetched once, EVP_sha1() would look the implementation up again on every init
+    const EVP_MD* sha1_md()
+    {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        static const EVP_MD* md = EVP_MD_fetch(nullptr, "SHA1", nullptr);
+        if (md)
+        {
+            return md;
+        }
+#endif
+        return EVP_sha1();
+    }
+
+    // One context per thread, reset between hashes rather than allocated for each
+    EVP_MD_CTX* thread_context()
+    {
+        thread_local std::unique_ptr<EVP_MD_CTX, MDContextDeleter> context(EVP_MD_CTX_new());
+        if (!context)
+        {
+            throw XGDException(ErrCode::MISC, HERE(), "Failed to create SHA1 context");
+        }
+        return context.get();
+    }
+
+    void digest(EVP_MD_CTX* context, const EVP_MD* md, const char* data, const size_t size, uint8_t* out_hash)
+    {
+        if (EVP_DigestInit_ex(context, md, nullptr) != 1 ||
+            EVP_DigestUpdate(context, data, size) != 1 ||
+            EVP_DigestFinal_ex(context, out_hash, nullptr) != 1)
+        {
+            throw XGDException(ErrCode::MISC, HERE(), "SHA1 failed");
+        }
+    }
+}
+
+void sha1(const char* data, const size_t size, uint8_t* out_hash)
+{
+    digest(thread_context(), sha1_md(), data, size, out_hash);
+}
+
+void sha1_blocks(const char* data, const size_t block_size, const size_t count, uint8_t* out_hashes)
+{
+    EVP_MD_CTX* context = thread_context();
+    const EVP_MD* md = sha1_md();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        digest(context, md, data + (i * block_size), block_size, out_hashes + (i * SHA1_SIZE));
+    }
+}
+
+}; // namespace HashUtils
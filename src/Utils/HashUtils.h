@@ -0,0 +1,14 @@
+#ifndef _HASH_UTILS_H_
+#define _HASH_UTILS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace HashUtils {
+    static constexpr size_t SHA1_SIZE = 20;
+
+    void sha1(const char* data, const size_t size, uint8_t* out_hash); // Uses SHA-NI where OpenSSL finds it
+    void sha1_blocks(const char* data, const size_t block_size, const size_t count, uint8_t* out_hashes); // Hashes count consecutive blocks, one SHA1_SIZE hash each
+};
+
+#endif // _HASH_UTILS_H_
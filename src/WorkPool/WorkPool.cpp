@@ -0,0 +1,210 @@
+#include <algorithm>
+
+#include "XGD.h"
+#include "WorkPool/WorkPool.h"
+
+namespace
+{
+    // Index of the pool worker running on this thread, SIZE_MAX for threads outside the pool
+    thread_local size_t current_worker_idx = SIZE_MAX;
+}
+
+WorkPool& WorkPool::shared()
+{
+    static WorkPool work_pool;
+    return work_pool;
+}
+
+WorkPool::~WorkPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_flag_ = true;
+    }
+
+    cv_.notify_all();
+
+    for (std::thread& thread : thread_pool_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+void WorkPool::start_threads()
+{
+    uint32_t num_workers = std::max(std::min(std::thread::hardware_concurrency(), static_cast<uint32_t>(32)), static_cast<uint32_t>(1));
+
+    for (uint32_t i = 0; i < num_workers; ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+
+    for (uint32_t i = 0; i < num_workers; ++i)
+    {
+        thread_pool_.emplace_back(&WorkPool::thread_worker, this, i);
+    }
+}
+
+size_t WorkPool::num_threads()
+{
+    std::call_once(start_flag_, &WorkPool::start_threads, this);
+    return thread_pool_.size();
+}
+
+void WorkPool::submit(std::function<void()> task)
+{
+    size_t num_workers = num_threads();
+    size_t worker_idx = (current_worker_idx < num_workers) ? current_worker_idx : (next_worker_++ % num_workers);
+
+    {
+        std::lock_guard<std::mutex> lock(workers_[worker_idx]->mutex);
+        workers_[worker_idx]->tasks.push_back(std::move(task));
+    }
+
+    ++pending_tasks_;
+
+    // Taking the lock first means a worker that just found nothing to do is already waiting
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    cv_.notify_one();
+}
+
+void WorkPool::run(const size_t count, const std::function<void(size_t)>& task)
+{
+    if (count < 2 || num_threads() < 2)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->task = &task;
+    job->count = count;
+
+    // Helpers that start after every index has been handed out return straight away
+    size_t num_helpers = std::min(count - 1, num_threads());
+
+    for (size_t i = 0; i < num_helpers; ++i)
+    {
+        submit([this, job] { work_on(*job); });
+    }
+
+    work_on(*job);
+
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->cv.wait(lock, [&job] { return job->done == job->count; });
+    }
+
+    if (job->error)
+    {
+        std::rethrow_exception(job->error);
+    }
+}
+
+void WorkPool::work_on(Job& job)
+{
+    while (true)
+    {
+        size_t index = job.next++;
+        if (index >= job.count)
+        {
+            return;
+        }
+
+        try
+        {
+            (*job.task)(index);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            if (!job.error)
+            {
+                job.error = std::current_exception();
+            }
+        }
+
+        if (++job.done == job.count)
+        {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            job.cv.notify_all();
+        }
+    }
+}
+
+bool WorkPool::take_task(size_t worker_idx, std::function<void()>& out_task)
+{
+    // Newest task from our own deque first, it's the most likely to still be in cache
+    {
+        Worker& worker = *workers_[worker_idx];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+
+        if (!worker.tasks.empty())
+        {
+            out_task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            --pending_tasks_;
+            return true;
+        }
+    }
+
+    // Then steal the oldest task from another worker
+    for (size_t i = 1; i < workers_.size(); ++i)
+    {
+        Worker& victim = *workers_[(worker_idx + i) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (!victim.tasks.empty())
+        {
+            out_task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --pending_tasks_;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkPool::thread_worker(size_t worker_idx)
+{
+    current_worker_idx = worker_idx;
+
+    while (true)
+    {
+        std::function<void()> task;
+
+        if (take_task(worker_idx, task))
+        {
+            try
+            {
+                task();
+            }
+            catch (const std::exception& e)
+            {
+                XGDLog(Error) << "Unhandled exception in work pool task: " << e.what() << XGDLog::Endl;
+            }
+            catch (...)
+            {
+                XGDLog(Error) << "Unhandled exception in work pool task" << XGDLog::Endl;
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        cv_.wait(lock, [this] { return stop_flag_ || pending_tasks_ > 0; });
+
+        if (stop_flag_)
+        {
+            return;
+        }
+    }
+}
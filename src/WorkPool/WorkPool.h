@@ -0,0 +1,75 @@
+#ifndef _WORK_POOL_H_
+#define _WORK_POOL_H_
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+/*  Process-wide set of worker threads shared by everything CPU heavy: decoding compressed images,
+    compressing output and hashing. Threads are started on first use and live until exit, so
+    converting a batch of images only pays the start up cost once.
+    Each worker has its own task deque, tasks queued from a worker go to the back of its own deque
+    and it takes them from there, idle workers steal from the front of the others' deques. */
+class WorkPool
+{
+public:
+    ~WorkPool();
+
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+
+    static WorkPool& shared();
+
+    /*  Calls task(i) for every i in [0, count) and returns once they're all done, the calling thread
+        works on the tasks too so it's safe to call from a pool task. Rethrows the first exception thrown by a task. */
+    void run(const size_t count, const std::function<void(size_t)>& task);
+
+    // Queues a task and returns immediately, the task must not throw
+    void submit(std::function<void()> task);
+
+    size_t num_threads();
+
+private:
+    struct Job
+    {
+        const std::function<void(size_t)>* task{nullptr};
+        size_t count{0};
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::exception_ptr error{nullptr};
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    struct Worker
+    {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> thread_pool_;
+    std::once_flag start_flag_;
+
+    std::atomic<size_t> pending_tasks_{0};
+    std::atomic<size_t> next_worker_{0}; // Round robin target for tasks queued from outside the pool
+    std::mutex sleep_mutex_;
+    std::condition_variable cv_;
+    bool stop_flag_{false};
+
+    WorkPool() = default;
+
+    void start_threads();
+    void thread_worker(size_t worker_idx);
+    bool take_task(size_t worker_idx, std::function<void()>& out_task);
+    void work_on(Job& job);
+};
+
+#endif // _WORK_POOL_H_
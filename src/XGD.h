@@ -18,7 +18,11 @@ namespace XGD {
     constexpr uint64_t OPTIMIZED_TAG_OFFSET  = 31337;
     constexpr uint64_t OPTIMIZED_TAG_LEN     = sizeof(OPTIMIZED_TAG) - 1;
 
-    constexpr uint64_t BUFFER_SIZE    = 0x10000; // 64KB
+    constexpr uint64_t BUFFER_SIZE      = 0x10000; // 64KB
+    constexpr uint64_t BULK_BUFFER_SIZE = 0x100000; // 1MB, sector copy loops, large enough to keep the work pool busy
+    constexpr uint64_t SCAN_BUFFER_SIZE = 0x800000; // 8MB, sequential whole image scans
+
+    constexpr uint32_t PREFETCH_SECTORS = 0x800; // 4MB read ahead of image writers by default
 
 };
 
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cstring>
+
+#include "XGD.h"
+#include "ZARExtractor/ZARReader.h"
+
+class ZARReader::FileBuffer : public std::streambuf
+{
+public:
+    FileBuffer(ZARReader& zar_reader, ZArchiveNodeHandle file_handle, const uint64_t file_size)
+        : zar_reader_(zar_reader), file_handle_(file_handle), file_size_(file_size), buffer_(XGD::BUFFER_SIZE)
+    {
+        setg(buffer_.data(), buffer_.data(), buffer_.data());
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr())
+        {
+            return traits_type::to_int_type(*gptr());
+        }
+
+        buffer_offset_ += egptr() - eback();
+
+        uint64_t bytes_read = zar_reader_.read_file(file_handle_, buffer_offset_, buffer_.size(), buffer_.data());
+        setg(buffer_.data(), buffer_.data(), buffer_.data() + bytes_read);
+
+        return bytes_read ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+    }
+
+    // Large reads skip the buffer and go straight to the archive
+    std::streamsize xsgetn(char* out_buffer, std::streamsize count) override
+    {
+        std::streamsize buffered = std::min(count, static_cast<std::streamsize>(egptr() - gptr()));
+
+        std::memcpy(out_buffer, gptr(), buffered);
+        gbump(static_cast<int>(buffered));
+
+        if (buffered == count || count - buffered < static_cast<std::streamsize>(buffer_.size()))
+        {
+            return buffered + std::streambuf::xsgetn(out_buffer + buffered, count - buffered);
+        }
+
+        uint64_t position = buffer_offset_ + (gptr() - eback());
+        uint64_t bytes_read = zar_reader_.read_file(file_handle_, position, count - buffered, out_buffer + buffered);
+
+        buffer_offset_ = position + bytes_read;
+        setg(buffer_.data(), buffer_.data(), buffer_.data());
+
+        return buffered + static_cast<std::streamsize>(bytes_read);
+    }
+
+    pos_type seekoff(off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+    {
+        switch (dir)
+        {
+            case std::ios_base::beg:
+                return seekpos(offset, which);
+            case std::ios_base::cur:
+                return seekpos(static_cast<off_type>(buffer_offset_ + (gptr() - eback())) + offset, which);
+            default:
+                return seekpos(static_cast<off_type>(file_size_) + offset, which);
+        }
+    }
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+    {
+        if (!(which & std::ios_base::in) || position < 0 || static_cast<uint64_t>(position) > file_size_)
+        {
+            return pos_type(off_type(-1));
+        }
+
+        buffer_offset_ = static_cast<uint64_t>(position);
+        setg(buffer_.data(), buffer_.data(), buffer_.data());
+        return position;
+    }
+
+private:
+    ZARReader& zar_reader_;
+    ZArchiveNodeHandle file_handle_;
+    uint64_t file_size_;
+
+    std::vector<char> buffer_;
+    uint64_t buffer_offset_{0}; // File offset of the start of buffer_
+};
+
+class ZARReader::FileStream : public std::istream
+{
+public:
+    FileStream(ZARReader& zar_reader, ZArchiveNodeHandle file_handle, const uint64_t file_size)
+        : std::istream(nullptr), file_buffer_(zar_reader, file_handle, file_size)
+    {
+        rdbuf(&file_buffer_);
+    }
+
+private:
+    FileBuffer file_buffer_;
+};
+
+ZARReader::ZARReader(const std::filesystem::path& in_zar_path)
+    : in_zar_path_(in_zar_path)
+{
+    z_reader_.reset(ZArchiveReader::OpenFromFile(in_zar_path_));
+
+    if (!z_reader_)
+    {
+        throw XGDException(ErrCode::FILE_OPEN, HERE(), "Failed to open ZArchive file: " + in_zar_path_.string());
+    }
+}
+
+std::vector<ZARReader::Entry> ZARReader::directory_entries(const std::string& dir_path)
+{
+    ZArchiveNodeHandle dir_handle = z_reader_->LookUp(dir_path, false, true);
+
+    if (dir_handle == ZARCHIVE_INVALID_NODE)
+    {
+        throw XGDException(ErrCode::FILE_READ, HERE(), "Directory not found in ZArchive: " + dir_path);
+    }
+
+    std::vector<Entry> entries;
+    uint32_t dir_entry_count = z_reader_->GetDirEntryCount(dir_handle);
+
+    for (uint32_t i = 0; i < dir_entry_count; ++i)
+    {
+        ZArchiveReader::DirEntry dir_entry;
+
+        if (!z_reader_->GetDirEntry(dir_handle, i, dir_entry))
+        {
+            throw XGDException(ErrCode::FILE_READ, HERE(), "Failed to read directory entry in ZArchive: " + dir_path);
+        }
+
+        if (!dir_entry.isDirectory && !dir_entry.isFile)
+        {
+            continue;
+        }
+
+        std::string name(dir_entry.name);
+        entries.push_back({ dir_path + "/" + name, name, dir_entry.isDirectory, dir_entry.isFile ? dir_entry.size : 0 });
+    }
+
+    return entries;
+}
+
+uint64_t ZARReader::total_file_bytes()
+{
+    return total_file_bytes_recursive("");
+}
+
+uint64_t ZARReader::total_file_bytes_recursive(const std::string& dir_path)
+{
+    uint64_t total = 0;
+
+    for (const Entry& entry : directory_entries(dir_path))
+    {
+        total += entry.is_directory ? total_file_bytes_recursive(entry.path) : entry.size;
+    }
+    return total;
+}
+
+std::unique_ptr<std::istream> ZARReader::open_file(const std::string& file_path)
+{
+    ZArchiveNodeHandle file_handle = z_reader_->LookUp(file_path, true, false);
+
+    if (file_handle == ZARCHIVE_INVALID_NODE)
+    {
+        throw XGDException(ErrCode::FILE_OPEN, HERE(), "File not found in ZArchive: " + file_path);
+    }
+
+    return std::make_unique<FileStream>(*this, file_handle, z_reader_->GetFileSize(file_handle));
+}
+
+uint64_t ZARReader::read_file(ZArchiveNodeHandle file_handle, const uint64_t offset, const uint64_t size, char* out_buffer)
+{
+    std::lock_guard<std::mutex> lock(read_mutex_);
+
+    uint64_t total_read = 0;
+
+    while (total_read < size)
+    {
+        uint64_t bytes_read = z_reader_->ReadFromFile(file_handle, offset + total_read, size - total_read, out_buffer + total_read);
+        if (bytes_read == 0)
+        {
+            break;
+        }
+        total_read += bytes_read;
+    }
+    return total_read;
+}
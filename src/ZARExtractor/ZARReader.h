@@ -0,0 +1,52 @@
+#ifndef _ZAR_READER_H_
+#define _ZAR_READER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <istream>
+#include <filesystem>
+
+#include "zarchive/zarchivereader.h"
+
+/*  Read access to the files in a ZAR archive, so an image can be rebuilt
+    straight from the archive without extracting it to a temp directory first.
+    Paths are relative to the archive root and start with a '/', same as ZARExtractor. */
+class ZARReader
+{
+public:
+    struct Entry
+    {
+        std::string path;
+        std::string name;
+        bool is_directory{false};
+        uint64_t size{0};
+    };
+
+    ZARReader(const std::filesystem::path& in_zar_path);
+    ~ZARReader() = default;
+
+    std::string name() { return in_zar_path_.stem().string(); };
+
+    // Entries directly inside dir_path, pass an empty string for the root directory
+    std::vector<Entry> directory_entries(const std::string& dir_path);
+    uint64_t total_file_bytes();
+
+    // Seekable stream over a file in the archive, valid for as long as the ZARReader is alive
+    std::unique_ptr<std::istream> open_file(const std::string& file_path);
+
+private:
+    class FileBuffer;
+    class FileStream;
+
+    std::filesystem::path in_zar_path_;
+    std::unique_ptr<ZArchiveReader> z_reader_{nullptr};
+    std::mutex read_mutex_;
+
+    uint64_t read_file(ZArchiveNodeHandle file_handle, const uint64_t offset, const uint64_t size, char* out_buffer);
+    uint64_t total_file_bytes_recursive(const std::string& dir_path);
+};
+
+#endif // _ZAR_READER_H_
@@ -1,9 +1,12 @@
 #include <cstdint>
 #include <filesystem>
+#include <map>
+#include <string>
 
 #include "XGD.h"
 #include "InputHelper/Types.h"
 #include "InputHelper/InputHelper.h" 
+#include "SplitFStream/SplitFStream.h"
 
 #ifndef ENABLE_GUI
 
@@ -35,11 +38,17 @@ int main(int argc, char** argv)
     output_format_group->add_flag_function("--xenia",    [&](int64_t) { output_settings.auto_format = AutoFormat::XENIA;   }, "Automatically choose format and settings for use with Xenia");
 
     output_format_group->add_flag_function("--list",     [&](int64_t) { output_settings.file_type = FileType::LIST; }, "List file contents of input image");
+    output_format_group->add_flag_function("--verify",   [&](int64_t) { output_settings.file_type = FileType::VERIFY; }, "Verify the hash tables of GoD input");
     output_format_group->set_help_flag    ("--help",     "Print this help message and exit");
     output_format_group->set_version_flag ("--version",  XGD::VERSION);
 
     auto* settings_group = app.add_option_group("Settings");
 
+    const std::map<std::string, CompressionPreset> compression_presets
+    {
+        { "fast", CompressionPreset::FAST }, { "hc", CompressionPreset::HC }, { "max", CompressionPreset::MAX }, { "adaptive", CompressionPreset::ADAPTIVE }
+    };
+
     settings_group->add_flag_function("--partial-scrub", [&](int64_t) { output_settings.scrub_type = ScrubType::PARTIAL; }, "Scrubs and trims the output image, random padding data is removed");
     settings_group->add_flag_function("--full-scrub",    [&](int64_t) { output_settings.scrub_type = ScrubType::FULL;    }, "Completely reauthor the resulting image, this will produce the smallest file possible");
     settings_group->add_flag_function("--split",         [&](int64_t) { output_settings.split = true;                    }, "Splits the resulting XISO file if it's too large for OG Xbox");
@@ -47,6 +56,17 @@ int main(int argc, char** argv)
     settings_group->add_flag_function("--attach-xbe",    [&](int64_t) { output_settings.attach_xbe = true;               }, "Generates an attach XBE file along with the output file");
     settings_group->add_flag_function("--am-patch",      [&](int64_t) { output_settings.allowed_media_patch = true;      }, "Patches the Allowed Media field in resulting XBE files");
     settings_group->add_flag_function("--offline",       [&](int64_t) { output_settings.offline_mode = true;             }, "Disables online functionality, will result in less accurate file naming");
+    settings_group->add_option       ("--sector-cache",  output_settings.sector_cache_size,                                    "Number of input sectors to cache while reading, on by default for CSO/CCI input, 0 disables the cache");
+    settings_group->add_option       ("--prefetch",      output_settings.prefetch_sectors,                                     "Number of sectors to read ahead of the output while converting images, 0 disables read-ahead");
+    settings_group->add_option       ("--compression",   output_settings.compression_preset,                                   "CSO/CCI compression: fast, hc, max (default) or adaptive, which lowers the level to keep up with the output drive")
+                  ->transform(CLI::CheckedTransformer(compression_presets, CLI::ignore_case));
+    settings_group->add_option_function<int>("--hc-level", [&](const int& level) { output_settings.compression_preset = CompressionPreset::HC; output_settings.compression_level = level; }, "Compress CSO/CCI output with LZ4 HC at this level, from 3 to 12")
+                  ->check(CLI::Range(3, 12));
+    settings_group->add_option       ("--meta-cache",    output_settings.metadata_cache_dir,                                   "Directory to cache parsed image metadata in, speeds up repeated runs on the same input");
+    settings_group->add_flag_function("--meta-cache-refresh", [&](int64_t) { output_settings.metadata_cache_mode = MetadataCacheMode::REFRESH; }, "Ignore cached metadata for the input and store it again");
+    settings_group->add_flag_function("--meta-cache-clear",   [&](int64_t) { output_settings.metadata_cache_mode = MetadataCacheMode::CLEAR;   }, "Remove cached metadata for the input");
+    settings_group->add_flag_function("--no-io-uring",  [&](int64_t) { split::io_ring::set_enabled(false);           }, "Read input and write output with plain positional I/O instead of io_uring on Linux");
+    settings_group->add_flag_function("--streaming",    [&](int64_t) { split::set_streaming_mode(true);             }, "Keep input and output files out of the page cache, for converting many large images in one go");
     settings_group->add_flag_function("--debug",         [&](int64_t) { XGDLog().set_log_level(LogLevel::Debug);         }, "Enable debug logging");
     settings_group->add_flag_function("--quiet",         [&](int64_t) { XGDLog().set_log_level(LogLevel::Error);         }, "Disable all logging except for warnings and errors");
 